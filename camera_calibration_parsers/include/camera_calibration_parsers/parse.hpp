@@ -35,7 +35,10 @@
 #ifndef CAMERA_CALIBRATION_PARSERS__PARSE_HPP_
 #define CAMERA_CALIBRATION_PARSERS__PARSE_HPP_
 
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "sensor_msgs/msg/camera_info.hpp"
 #include "camera_calibration_parsers/visibility_control.hpp"
@@ -49,7 +52,7 @@ using CameraInfo = sensor_msgs::msg::CameraInfo;
 /**
  * \brief Write calibration parameters to a file.
  *
- * The file name extension (.yml, .yaml, or .ini) determines the output format.
+ * The file name extension (.yml, .yaml, .ini, or .ccal) determines the output format.
  *
  * \param file_name File to write
  * \param camera_name Name of the camera
@@ -63,7 +66,8 @@ bool writeCalibration(
 /**
  * \brief Read calibration parameters from a file.
  *
- * The file may be YAML or INI format.
+ * The file may be YAML, INI, or binary format. Files without one of the known extensions
+ * are recognized by their content.
  *
  * \param file_name File to read
  * \param[out] camera_name Name of the camera
@@ -74,11 +78,36 @@ bool readCalibration(
   const std::string & file_name, std::string & camera_name,
   CameraInfo & cam_info);
 
+/**
+ * \brief Outcome of loading one file with readCalibrations().
+ */
+struct CalibrationFileResult
+{
+  std::string file_name;
+  bool success = false;
+  std::string camera_name;
+  CameraInfo cam_info;
+};
+
+/**
+ * \brief Read calibration parameters from many files concurrently.
+ *
+ * Each file is read as by readCalibration(); a file that fails to load does not affect
+ * the others.
+ *
+ * \param file_names Files to read
+ * \param max_threads Upper bound on the number of threads; 0 for the hardware concurrency
+ * \return One result per file, in the order of file_names
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+std::vector<CalibrationFileResult> readCalibrations(
+  const std::vector<std::string> & file_names, std::size_t max_threads = 0);
+
 /**
  * \brief Parse calibration parameters from a string in memory.
  *
  * \param buffer Calibration string
- * \param format Format of calibration string, "yml" or "ini"
+ * \param format Format of calibration string, "yml", "ini" or "bin"; empty to detect it
  * \param[out] camera_name Name of the camera
  * \param[out] cam_info Camera parameters
  */
@@ -87,6 +116,34 @@ bool parseCalibration(
   const std::string & buffer, const std::string & format,
   std::string & camera_name, CameraInfo & cam_info);
 
+/**
+ * \brief Parse calibration parameters from memory, detecting the format from the content.
+ *
+ * The buffer is parsed in place, so calibrations received as parameters, service requests
+ * or bundle records need neither a temporary file nor a copy.
+ *
+ * \param buffer Calibration string
+ * \param[out] camera_name Name of the camera
+ * \param[out] cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool parseCalibration(
+  std::string_view buffer, std::string & camera_name,
+  CameraInfo & cam_info);
+
+/**
+ * \brief Determine the format of a calibration held in memory.
+ *
+ * Binary calibrations are recognized by their magic number. For text, looks at the first
+ * line that is not blank or a comment: an INI section header means "ini", a YAML
+ * directive, document marker or "key:" mapping means "yml".
+ *
+ * \param buffer Calibration string
+ * \return "bin", "yml", "ini", or an empty string if the format is not recognized
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+std::string detectCalibrationFormat(std::string_view buffer);
+
 }  // namespace camera_calibration_parsers
 
 #endif  // CAMERA_CALIBRATION_PARSERS__PARSE_HPP_
@@ -0,0 +1,134 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef CAMERA_CALIBRATION_PARSERS__PARSE_BIN_HPP_
+#define CAMERA_CALIBRATION_PARSERS__PARSE_BIN_HPP_
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "sensor_msgs/msg/camera_info.hpp"
+#include "camera_calibration_parsers/visibility_control.hpp"
+
+namespace camera_calibration_parsers
+{
+
+using CameraInfo = sensor_msgs::msg::CameraInfo;
+
+/*
+ * Binary calibration format, conventionally stored as ".ccal" files.
+ *
+ * A fixed 16 byte header is followed by the payload. All integers are little-endian and
+ * doubles are IEEE 754 binary64, so values are stored bit-exactly:
+ *
+ *     header   char[4] magic "CCAL", u16 version (1), u16 reserved (0),
+ *              u32 payload size, u32 CRC-32 (IEEE) of the payload
+ *     payload  u32 width, height, binning_x, binning_y,
+ *              u32 roi x_offset, y_offset, height, width, u8 roi do_rectify, u8[3] zero,
+ *              f64 K[9], R[9], P[12],
+ *              u16 camera name length, u16 distortion model length, u32 D length,
+ *              camera name bytes, distortion model bytes, f64 D[D length]
+ *
+ * Readers reject other versions and a nonzero reserved field. Bytes past the end of the
+ * version 1 payload are ignored, leaving room for compatible additions.
+ */
+
+/// Magic number at the start of binary calibrations.
+constexpr std::string_view kCalibrationBinMagic = "CCAL";
+
+/**
+ * \brief Write calibration parameters in binary format.
+ *
+ * \param out Output stream to write to, opened in binary mode
+ * \param camera_name Name of the camera
+ * \param cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool writeCalibrationBin(
+  std::ostream & out, const std::string & camera_name,
+  const CameraInfo & cam_info);
+
+/**
+ * \brief Read calibration parameters in binary format.
+ *
+ * \param in Input stream to read from, opened in binary mode
+ * \param[out] camera_name Name of the camera
+ * \param[out] cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool readCalibrationBin(
+  std::istream & in, std::string & camera_name,
+  CameraInfo & cam_info);
+
+/**
+ * \brief Write calibration parameters to a file in binary format.
+ *
+ * \param file_name File to write
+ * \param camera_name Name of the camera
+ * \param cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool writeCalibrationBin(
+  const std::string & file_name, const std::string & camera_name,
+  const CameraInfo & cam_info);
+
+/**
+ * \brief Read calibration parameters from a binary file.
+ *
+ * \param file_name File to read
+ * \param[out] camera_name Name of the camera
+ * \param[out] cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool readCalibrationBin(
+  const std::string & file_name, std::string & camera_name,
+  CameraInfo & cam_info);
+
+/**
+ * \brief Parse calibration parameters in binary format from memory.
+ *
+ * \param buffer Binary calibration
+ * \param[out] camera_name Name of the camera
+ * \param[out] cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool parseCalibrationBin(
+  std::string_view buffer, std::string & camera_name,
+  CameraInfo & cam_info);
+
+}  // namespace camera_calibration_parsers
+
+#endif  // CAMERA_CALIBRATION_PARSERS__PARSE_BIN_HPP_
@@ -0,0 +1,180 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef CAMERA_CALIBRATION_PARSERS__PARSE_BUNDLE_HPP_
+#define CAMERA_CALIBRATION_PARSERS__PARSE_BUNDLE_HPP_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sensor_msgs/msg/camera_info.hpp"
+#include "camera_calibration_parsers/visibility_control.hpp"
+
+namespace camera_calibration_parsers
+{
+
+using CameraInfo = sensor_msgs::msg::CameraInfo;
+
+/**
+ * \brief Calibrations of many cameras in one indexed file.
+ *
+ * A bundle starts with a text index of its records, by camera, followed by one YAML
+ * calibration record per camera:
+ *
+ *     %CALIBRATION_BUNDLE 1 <count>
+ *     <camera> <offset> <size>
+ *     ...
+ *     %END
+ *     <records>
+ *
+ * with offsets relative to the first record. Opening a bundle maps the file and reads only
+ * the index; records are decoded when read. Cameras are keyed by a name of alphanumeric and
+ * '_' characters, like CameraInfoManager camera names.
+ */
+class CalibrationBundle
+{
+public:
+  /**
+   * \brief Open a bundle, reading its index.
+   *
+   * \param file_name Bundle file
+   * \return The bundle, or nullptr if the file cannot be read or is not a valid bundle.
+   */
+  CAMERA_CALIBRATION_PARSERS_PUBLIC
+  static std::shared_ptr<const CalibrationBundle> open(const std::string & file_name);
+
+  /**
+   * \brief Cameras in the bundle, in file order.
+   */
+  CAMERA_CALIBRATION_PARSERS_PUBLIC
+  std::vector<std::string> cameras() const;
+
+  CAMERA_CALIBRATION_PARSERS_PUBLIC
+  bool has(const std::string & camera) const;
+
+  /**
+   * \brief Encoded record of a camera, without decoding it.
+   *
+   * \return The YAML record, empty if \a camera is not in the bundle. It points into the
+   * mapped file and is valid as long as the bundle.
+   */
+  CAMERA_CALIBRATION_PARSERS_PUBLIC
+  std::string_view record(const std::string & camera) const;
+
+  /**
+   * \brief Decode the record of one camera.
+   *
+   * \param camera Camera key in the bundle
+   * \param[out] camera_name Name of the camera stored in its record
+   * \param[out] cam_info Camera parameters
+   */
+  CAMERA_CALIBRATION_PARSERS_PUBLIC
+  bool read(
+    const std::string & camera, std::string & camera_name,
+    CameraInfo & cam_info) const;
+
+  /**
+   * \brief Decode all records in one pass.
+   *
+   * \param[out] cam_infos Camera parameters by camera key
+   */
+  CAMERA_CALIBRATION_PARSERS_PUBLIC
+  bool readAll(std::map<std::string, CameraInfo> & cam_infos) const;
+
+private:
+  CalibrationBundle() = default;
+
+  struct Impl;
+  std::shared_ptr<Impl> impl_;
+};
+
+/**
+ * \brief Read the calibration of one camera from a bundle.
+ *
+ * \param file_name Bundle file
+ * \param camera Camera key in the bundle
+ * \param[out] camera_name Name of the camera stored in its record
+ * \param[out] cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool readCalibrationBundle(
+  const std::string & file_name, const std::string & camera,
+  std::string & camera_name, CameraInfo & cam_info);
+
+/**
+ * \brief Read the calibrations of all cameras in a bundle.
+ *
+ * \param file_name Bundle file
+ * \param[out] cam_infos Camera parameters by camera key
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool readCalibrationBundle(
+  const std::string & file_name, std::map<std::string, CameraInfo> & cam_infos);
+
+/**
+ * \brief Store the calibration of one camera in a bundle.
+ *
+ * Only the record of \a camera is encoded, the others are copied as they are. The bundle is
+ * created if it does not exist, and replaced atomically otherwise. Nothing is written if the
+ * record would not change.
+ *
+ * Writers of the same bundle are serialized, across processes by a lock on "<file_name>.lock",
+ * which is left next to the bundle, so that concurrent updates of different cameras are all kept.
+ *
+ * \param file_name Bundle file
+ * \param camera Camera key in the bundle
+ * \param camera_name Name of the camera stored in its record
+ * \param cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool writeCalibrationBundle(
+  const std::string & file_name, const std::string & camera,
+  const std::string & camera_name, const CameraInfo & cam_info);
+
+/**
+ * \brief Write a bundle of calibrations, replacing any existing file atomically.
+ *
+ * \param file_name Bundle file
+ * \param cam_infos Camera parameters by camera key, also used as camera names
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool writeCalibrationBundle(
+  const std::string & file_name, const std::map<std::string, CameraInfo> & cam_infos);
+
+}  // namespace camera_calibration_parsers
+
+#endif  // CAMERA_CALIBRATION_PARSERS__PARSE_BUNDLE_HPP_
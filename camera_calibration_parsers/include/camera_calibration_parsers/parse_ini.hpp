@@ -38,6 +38,7 @@
 #include <istream>
 #include <ostream>
 #include <string>
+#include <string_view>
 
 #include "sensor_msgs/msg/camera_info.hpp"
 #include "camera_calibration_parsers/visibility_control.hpp"
@@ -107,6 +108,29 @@ bool parseCalibrationIni(
   const std::string & buffer, std::string & camera_name,
   CameraInfo & cam_info);
 
+/**
+ * \brief Parse calibration parameters from a string in memory of INI format.
+ *
+ * The buffer is parsed in place in a single pass; errors name the offending key and line.
+ *
+ * \param buffer Calibration string
+ * \param[out] camera_name Name of the camera
+ * \param[out] cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool parseCalibrationIni(
+  std::string_view buffer, std::string & camera_name,
+  CameraInfo & cam_info);
+
+/// \cond
+inline bool parseCalibrationIni(
+  const char * buffer, std::string & camera_name,
+  CameraInfo & cam_info)
+{
+  return parseCalibrationIni(std::string_view(buffer), camera_name, cam_info);
+}
+/// \endcond
+
 }  // namespace camera_calibration_parsers
 
 #endif  // CAMERA_CALIBRATION_PARSERS__PARSE_INI_HPP_
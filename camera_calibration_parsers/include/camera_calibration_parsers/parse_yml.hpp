@@ -38,6 +38,7 @@
 #include <istream>
 #include <ostream>
 #include <string>
+#include <string_view>
 
 #include "sensor_msgs/msg/camera_info.hpp"
 #include "camera_calibration_parsers/visibility_control.hpp"
@@ -107,6 +108,30 @@ bool parseCalibrationYml(
   const std::string & buffer, std::string & camera_name,
   CameraInfo & cam_info);
 
+/**
+ * \brief Parse calibration parameters from a string in memory of yaml format.
+ *
+ * Calibrations in the layout written by writeCalibrationYml() are parsed in place; other
+ * YAML is copied once for yaml-cpp.
+ *
+ * \param buffer Calibration string
+ * \param[out] camera_name Name of the camera
+ * \param[out] cam_info Camera parameters
+ */
+CAMERA_CALIBRATION_PARSERS_PUBLIC
+bool parseCalibrationYml(
+  std::string_view buffer, std::string & camera_name,
+  CameraInfo & cam_info);
+
+/// \cond
+inline bool parseCalibrationYml(
+  const char * buffer, std::string & camera_name,
+  CameraInfo & cam_info)
+{
+  return parseCalibrationYml(std::string_view(buffer), camera_name, cam_info);
+}
+/// \endcond
+
 }  // namespace camera_calibration_parsers
 
 #endif  // CAMERA_CALIBRATION_PARSERS__PARSE_YML_HPP_
@@ -33,37 +33,231 @@
 *********************************************************************/
 
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <map>
 #include <string>
+#include <system_error>
+#include <vector>
+
+#ifndef _WIN32
+#include <glob.h>
+#endif
 
 #include "rclcpp/logging.hpp"
 #include "sensor_msgs/msg/camera_info.hpp"
 #include "camera_calibration_parsers/parse.hpp"
 
+#include "parallel_for.hpp"
+
 using camera_calibration_parsers::readCalibration;
+using camera_calibration_parsers::readCalibrations;
 using camera_calibration_parsers::writeCalibration;
 
+static void usage(const char * program)
+{
+  printf(
+    "Usage: %s input.yml output.ini\n"
+    "       %s input.ini output.yml\n"
+    "       %s input.yml output.ccal\n"
+    "       %s [-j THREADS] [-o OUTPUT_DIR] --to FORMAT INPUT...\n"
+    "       %s [-j THREADS] --check INPUT...\n"
+    "\n"
+    "Formats follow the file extension: .yml/.yaml (YAML), .ini (INI), .ccal (binary).\n"
+    "\n"
+    "The --to form converts many calibrations in parallel, the --check form only loads them\n"
+    "to check that they are valid. INPUT may be a file, a directory (every calibration file\n"
+    "in it) or a quoted glob pattern.\n"
+    "  --to FORMAT    output format: yml, yaml, ini or ccal\n"
+    "  -o OUTPUT_DIR  directory for the converted files, by default next to each input\n"
+    "  -j THREADS     number of threads, by default one per core\n",
+    program, program, program, program, program);
+}
+
+static bool isCalibrationFile(const std::filesystem::path & path)
+{
+  const std::string ext = path.extension().string();
+  return ext == ".yml" || ext == ".yaml" || ext == ".ini" || ext == ".ccal";
+}
+
+// Expand one INPUT argument into calibration file names.
+static void expandInput(const std::string & input, std::vector<std::string> & files)
+{
+  std::error_code ec;
+  if (std::filesystem::is_directory(input, ec)) {
+    std::vector<std::string> found;
+    for (const auto & entry : std::filesystem::directory_iterator(input, ec)) {
+      if (entry.is_regular_file(ec) && isCalibrationFile(entry.path())) {
+        found.push_back(entry.path().string());
+      }
+    }
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+    return;
+  }
+#ifndef _WIN32
+  if (input.find_first_of("*?[") != std::string::npos) {
+    glob_t matches;
+    if (glob(input.c_str(), 0, nullptr, &matches) == 0) {
+      for (size_t i = 0; i < matches.gl_pathc; ++i) {
+        files.push_back(matches.gl_pathv[i]);
+      }
+    }
+    globfree(&matches);
+    return;
+  }
+#endif
+  files.push_back(input);
+}
+
+static int runBatch(
+  const std::vector<std::string> & inputs, const std::string & format,
+  const std::string & output_dir, size_t threads)
+{
+  auto logger = rclcpp::get_logger("camera_calibration_parsers.convert");
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::string> files;
+  for (const auto & input : inputs) {
+    size_t before = files.size();
+    expandInput(input, files);
+    if (files.size() == before) {
+      RCLCPP_WARN(logger, "No calibration files match %s", input.c_str());
+    }
+  }
+
+  auto results = readCalibrations(files, threads);
+
+  // One flag per file, written by the writer threads; not a vector<bool>, which packs bits.
+  std::vector<char> ok(results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    ok[i] = results[i].success;
+  }
+  if (!format.empty()) {
+    std::error_code ec;
+    if (!output_dir.empty()) {
+      std::filesystem::create_directories(output_dir, ec);
+    }
+
+    // Inputs with the same stem would be written to the same file; convert none of them.
+    std::vector<std::filesystem::path> outputs(results.size());
+    std::map<std::filesystem::path, size_t> first_input;
+    for (size_t i = 0; i < results.size(); ++i) {
+      std::filesystem::path in(results[i].file_name);
+      outputs[i] = output_dir.empty() ? in.parent_path() : std::filesystem::path(output_dir);
+      outputs[i] /= in.stem().string() + "." + format;
+      if (!results[i].success) {
+        continue;
+      }
+      auto key = std::filesystem::absolute(outputs[i], ec).lexically_normal();
+      auto [it, inserted] = first_input.emplace(ec ? outputs[i] : key, i);
+      if (!inserted) {
+        RCLCPP_ERROR(
+          logger, "%s and %s would both be saved to %s", results[it->second].file_name.c_str(),
+          results[i].file_name.c_str(), outputs[i].string().c_str());
+        ok[it->second] = false;
+        ok[i] = false;
+      }
+    }
+
+    camera_calibration_parsers::impl::parallelFor(
+      results.size(), threads, [&](size_t i) {
+        if (!ok[i]) {
+          return;
+        }
+        const std::string out = outputs[i].string();
+        try {
+          if (!writeCalibration(out, results[i].camera_name, results[i].cam_info)) {
+            RCLCPP_ERROR(logger, "Failed to save camera model to file %s", out.c_str());
+            ok[i] = false;
+          }
+        } catch (const std::exception & e) {
+          RCLCPP_ERROR(logger, "Failed to save camera model to file %s: %s", out.c_str(), e.what());
+          ok[i] = false;
+        }
+      });
+  }
+
+  size_t failed = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (!ok[i]) {
+      ++failed;
+      printf("  failed: %s\n", results[i].file_name.c_str());
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf(
+    "%s %zu of %zu calibration files in %.2f s, %zu failed\n",
+    format.empty() ? "Validated" : "Converted", results.size() - failed, results.size(),
+    seconds, failed);
+  return failed == 0 && !results.empty() ? 0 : -1;
+}
+
 int main(int argc, char ** argv)
 {
   auto logger = rclcpp::get_logger("camera_calibration_parsers.convert");
-  if (argc < 3) {
-    printf(
-      "Usage: %s input.yml output.ini\n"
-      "       %s input.ini output.yml\n", argv[0], argv[0]);
+
+  std::string format;
+  std::string output_dir;
+  size_t threads = 0;
+  bool batch = false;
+  bool check = false;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--to" && has_value) {
+      format = argv[++i];
+      batch = true;
+    } else if (arg == "-o" && has_value) {
+      output_dir = argv[++i];
+      batch = true;
+    } else if (arg == "-j" && has_value) {
+      threads = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+      batch = true;
+    } else if (arg == "--check") {
+      check = true;
+      batch = true;
+    } else if (arg == "-h" || arg == "--help" || (arg.size() > 1 && arg[0] == '-')) {
+      usage(argv[0]);
+      return 0;
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+
+  if (batch) {
+    if (inputs.empty() || check == !format.empty()) {
+      usage(argv[0]);
+      return -1;
+    }
+    if (format != "yml" && format != "yaml" && format != "ini" && format != "ccal" && !check) {
+      RCLCPP_ERROR(logger, "Unknown output format %s", format.c_str());
+      return -1;
+    }
+    return runBatch(inputs, format, output_dir, threads);
+  }
+
+  if (inputs.size() != 2) {
+    usage(argv[0]);
     return 0;
   }
 
   std::string name;
   sensor_msgs::msg::CameraInfo cam_info;
-  if (!readCalibration(argv[1], name, cam_info)) {
-    RCLCPP_ERROR(logger, "Failed to load camera model from file %s", argv[1]);
+  if (!readCalibration(inputs[0], name, cam_info)) {
+    RCLCPP_ERROR(logger, "Failed to load camera model from file %s", inputs[0].c_str());
     return -1;
   }
-  if (!writeCalibration(argv[2], name, cam_info)) {
-    RCLCPP_ERROR(logger, "Failed to save camera model to file %s", argv[2]);
+  if (!writeCalibration(inputs[1], name, cam_info)) {
+    RCLCPP_ERROR(logger, "Failed to save camera model to file %s", inputs[1].c_str());
     return -1;
   }
 
-  RCLCPP_INFO(logger, "Saved %s", argv[2]);
+  RCLCPP_INFO(logger, "Saved %s", inputs[1].c_str());
   return 0;
 }
@@ -0,0 +1,142 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "mapped_file.hpp"
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace camera_calibration_parsers
+{
+namespace impl
+{
+
+#ifndef _WIN32
+// Below this size a single read() is cheaper than setting up and tearing down a mapping.
+static constexpr size_t kMapThreshold = 64 * 1024;
+
+// Read from fd until EOF, or until size_hint bytes for regular files.
+static bool readAll(int fd, size_t size_hint, bool exact, std::string & buffer)
+{
+  buffer.resize(size_hint > 0 ? size_hint : 4096);
+  size_t total = 0;
+  for (;;) {
+    if (total == buffer.size()) {
+      if (exact) {
+        break;
+      }
+      buffer.resize(buffer.size() * 2);
+    }
+    ssize_t n = ::read(fd, &buffer[total], buffer.size() - total);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (n == 0) {
+      break;
+    }
+    total += static_cast<size_t>(n);
+  }
+  buffer.resize(total);
+  return true;
+}
+#endif
+
+MappedFile::MappedFile(const std::string & file_name)
+{
+#ifndef _WIN32
+  int fd = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0) {
+    const size_t size = static_cast<size_t>(st.st_size);
+    const bool regular = S_ISREG(st.st_mode);
+    if (regular && size >= kMapThreshold) {
+      int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+      flags |= MAP_POPULATE;
+#endif
+      void * mapping = mmap(nullptr, size, PROT_READ, flags, fd, 0);
+      if (mapping != MAP_FAILED) {
+        mapping_ = mapping;
+        data_ = std::string_view(static_cast<const char *>(mapping), size);
+        valid_ = true;
+      }
+    }
+    if (!valid_ && (regular || !S_ISDIR(st.st_mode)) && readAll(fd, size, regular, buffer_)) {
+      data_ = buffer_;
+      valid_ = true;
+    }
+  }
+  ::close(fd);
+#else
+  std::ifstream in(file_name, std::ios::binary | std::ios::ate);
+  if (in.good()) {
+    std::streamoff size = in.tellg();
+    in.seekg(0);
+    if (size > 0) {
+      buffer_.resize(static_cast<size_t>(size));
+      in.read(&buffer_[0], size);
+      buffer_.resize(static_cast<size_t>(in.gcount()));
+    }
+    data_ = buffer_;
+    valid_ = true;
+  }
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+  if (mapping_) {
+    munmap(mapping_, data_.size());
+  }
+#endif
+}
+
+}  // namespace impl
+}  // namespace camera_calibration_parsers
@@ -0,0 +1,85 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef PARALLEL_FOR_HPP_
+#define PARALLEL_FOR_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace camera_calibration_parsers
+{
+namespace impl
+{
+
+/**
+ * \brief Call fn(i) for every i in [0, count) on up to max_threads threads.
+ *
+ * Work is handed out one index at a time, so uneven items (a large file, a slow disk)
+ * balance across threads. The calling thread takes part. max_threads of 0 uses the
+ * hardware concurrency. fn must not throw.
+ */
+template<typename Fn>
+void parallelFor(std::size_t count, std::size_t max_threads, Fn && fn)
+{
+  if (count == 0) {
+    return;
+  }
+  std::size_t threads = max_threads ? max_threads : std::thread::hardware_concurrency();
+  threads = std::clamp<std::size_t>(threads, 1, count);
+
+  std::atomic<std::size_t> next{0};
+  auto worker = [&]() {
+      for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count; ) {
+        fn(i);
+      }
+    };
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (std::size_t t = 1; t < threads; ++t) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto & thread : pool) {
+    thread.join();
+  }
+}
+
+}  // namespace impl
+}  // namespace camera_calibration_parsers
+
+#endif  // PARALLEL_FOR_HPP_
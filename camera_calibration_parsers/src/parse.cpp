@@ -34,14 +34,21 @@
 
 #include "camera_calibration_parsers/parse.hpp"
 
+#include <exception>
 #include <filesystem>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "camera_calibration_parsers/parse_bin.hpp"
 #include "camera_calibration_parsers/parse_ini.hpp"
 #include "camera_calibration_parsers/parse_yml.hpp"
 
 #include "rclcpp/rclcpp.hpp"
 
+#include "mapped_file.hpp"
+#include "parallel_for.hpp"
+
 namespace camera_calibration_parsers
 {
 
@@ -55,10 +62,12 @@ bool writeCalibration(
     return writeCalibrationIni(file_name, camera_name, cam_info);
   } else if (p.extension().string() == ".yml" || p.extension().string() == ".yaml") {
     return writeCalibrationYml(file_name, camera_name, cam_info);
+  } else if (p.extension().string() == ".ccal") {
+    return writeCalibrationBin(file_name, camera_name, cam_info);
   } else {
     RCLCPP_ERROR(
       rclcpp::get_logger("camera_calibration_parsers"),
-      "Unrecognized format '%s', calibration must be '.ini', '.yml', or '.yaml'",
+      "Unrecognized format '%s', calibration must be '.ini', '.yml', '.yaml', or '.ccal'",
       p.extension().string().c_str());
   }
   return false;
@@ -74,25 +83,123 @@ bool readCalibration(
     return readCalibrationIni(file_name, camera_name, cam_info);
   } else if (p.extension().string() == ".yml" || p.extension().string() == ".yaml") {
     return readCalibrationYml(file_name, camera_name, cam_info);
-  } else {
-    RCLCPP_ERROR(
-      rclcpp::get_logger("camera_calibration_parsers"),
-      "Unrecognized format '%s', calibration must be '.ini', '.yml', or '.yaml'",
-      p.extension().string().c_str());
+  } else if (p.extension().string() == ".ccal") {
+    return readCalibrationBin(file_name, camera_name, cam_info);
   }
 
+  // Unknown extension: go by the content.
+  impl::MappedFile file(file_name);
+  if (file.valid() && !detectCalibrationFormat(file.data()).empty()) {
+    return parseCalibration(file.data(), camera_name, cam_info);
+  }
+  RCLCPP_ERROR(
+    rclcpp::get_logger("camera_calibration_parsers"),
+    "Unrecognized format '%s', calibration must be '.ini', '.yml', '.yaml', or '.ccal'",
+    p.extension().string().c_str());
   return false;
 }
 
+std::vector<CalibrationFileResult> readCalibrations(
+  const std::vector<std::string> & file_names, std::size_t max_threads)
+{
+  std::vector<CalibrationFileResult> results(file_names.size());
+  impl::parallelFor(
+    file_names.size(), max_threads, [&](std::size_t i) {
+      CalibrationFileResult & result = results[i];
+      result.file_name = file_names[i];
+      try {
+        result.success = readCalibration(result.file_name, result.camera_name, result.cam_info);
+      } catch (const std::exception & e) {
+        RCLCPP_ERROR(
+          rclcpp::get_logger("camera_calibration_parsers"),
+          "Failed to read camera calibration file [%s]: %s", result.file_name.c_str(), e.what());
+        result.success = false;
+      }
+    });
+  return results;
+}
+
 bool parseCalibration(
   const std::string & buffer, const std::string & format,
   std::string & camera_name, CameraInfo & cam_info)
 {
-  if (format != "ini") {
-    return false;
+  if (format.empty()) {
+    return parseCalibration(std::string_view(buffer), camera_name, cam_info);
+  } else if (format == "ini") {
+    return parseCalibrationIni(buffer, camera_name, cam_info);
+  } else if (format == "yml" || format == "yaml") {
+    return parseCalibrationYml(buffer, camera_name, cam_info);
+  } else if (format == "bin") {
+    return parseCalibrationBin(buffer, camera_name, cam_info);
+  }
+  RCLCPP_ERROR(
+    rclcpp::get_logger("camera_calibration_parsers"),
+    "Unrecognized format '%s', calibration must be 'ini', 'yml', or 'bin'", format.c_str());
+  return false;
+}
+
+bool parseCalibration(
+  std::string_view buffer, std::string & camera_name,
+  CameraInfo & cam_info)
+{
+  std::string format = detectCalibrationFormat(buffer);
+  // The text parsers do not expect a UTF-8 byte order mark, skipped by detection.
+  if (format != "bin" && buffer.substr(0, 3) == "\xEF\xBB\xBF") {
+    buffer.remove_prefix(3);
+  }
+  if (format == "ini") {
+    return parseCalibrationIni(buffer, camera_name, cam_info);
+  } else if (format == "yml") {
+    return parseCalibrationYml(buffer, camera_name, cam_info);
+  } else if (format == "bin") {
+    return parseCalibrationBin(buffer, camera_name, cam_info);
   }
+  RCLCPP_ERROR(
+    rclcpp::get_logger("camera_calibration_parsers"),
+    "Unable to detect the format of the calibration, expected YAML, INI, or binary");
+  return false;
+}
 
-  return parseCalibrationIni(buffer, camera_name, cam_info);
+std::string detectCalibrationFormat(std::string_view buffer)
+{
+  if (buffer.substr(0, kCalibrationBinMagic.size()) == kCalibrationBinMagic) {
+    return "bin";
+  }
+
+  // Skip a UTF-8 byte order mark.
+  if (buffer.substr(0, 3) == "\xEF\xBB\xBF") {
+    buffer.remove_prefix(3);
+  }
+
+  while (!buffer.empty()) {
+    std::size_t end = buffer.find('\n');
+    std::string_view line = buffer.substr(0, end);
+    buffer.remove_prefix(end == std::string_view::npos ? buffer.size() : end + 1);
+
+    std::size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+      continue;
+    }
+    line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+    if (line[0] == '#') {
+      // Comment in either format
+      continue;
+    }
+    if (line[0] == ';' || (line.front() == '[' && line.back() == ']')) {
+      return "ini";
+    }
+    if (line[0] == '%' || line.substr(0, 3) == "---") {
+      return "yml";
+    }
+    std::size_t colon = line.find(':');
+    if (colon != std::string_view::npos && colon > 0 &&
+      (colon + 1 == line.size() || line[colon + 1] == ' ' || line[colon + 1] == '\t'))
+    {
+      return "yml";
+    }
+    break;
+  }
+  return std::string();
 }
 
 }  // namespace camera_calibration_parsers
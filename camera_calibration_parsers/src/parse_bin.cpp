@@ -0,0 +1,397 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "camera_calibration_parsers/parse_bin.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "rclcpp/logging.hpp"
+
+#include "mapped_file.hpp"
+#include "replace_file.hpp"
+
+namespace camera_calibration_parsers
+{
+
+static rclcpp::Logger kBinLogger = rclcpp::get_logger("camera_calibration_parsers");
+
+/// \cond
+
+static constexpr uint16_t kBinVersion = 1;
+static constexpr std::size_t kBinHeaderSize = 16;
+// Everything in the version 1 payload up to the camera name.
+static constexpr std::size_t kBinFixedPayloadSize = 8 * 4 + 4 + 30 * 8 + 2 + 2 + 4;
+
+// CRC-32 as used by zlib and PNG (reflected polynomial 0xEDB88320).
+static constexpr std::array<uint32_t, 256> makeCrcTable()
+{
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; ++k) {
+      c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+    }
+    table[i] = c;
+  }
+  return table;
+}
+
+static constexpr std::array<uint32_t, 256> kCrcTable = makeCrcTable();
+
+static uint32_t crc32(std::string_view data)
+{
+  uint32_t crc = 0xFFFFFFFFu;
+  for (unsigned char c : data) {
+    crc = kCrcTable[(crc ^ c) & 0xFFu] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+// Little-endian encoding into a string.
+class BinWriter
+{
+public:
+  explicit BinWriter(std::string & out)
+  : out_(out)
+  {}
+
+  void u8(uint8_t v)
+  {
+    out_.push_back(static_cast<char>(v));
+  }
+
+  void u16(uint16_t v)
+  {
+    u8(static_cast<uint8_t>(v));
+    u8(static_cast<uint8_t>(v >> 8));
+  }
+
+  void u32(uint32_t v)
+  {
+    u16(static_cast<uint16_t>(v));
+    u16(static_cast<uint16_t>(v >> 16));
+  }
+
+  void f64(double v)
+  {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    u32(static_cast<uint32_t>(bits));
+    u32(static_cast<uint32_t>(bits >> 32));
+  }
+
+  void bytes(std::string_view v)
+  {
+    out_.append(v.data(), v.size());
+  }
+
+private:
+  std::string & out_;
+};
+
+// Little-endian decoding from a buffer. Reading past the end sets failed() and yields zeros.
+class BinReader
+{
+public:
+  explicit BinReader(std::string_view data)
+  : data_(data)
+  {}
+
+  uint8_t u8()
+  {
+    if (pos_ >= data_.size()) {
+      failed_ = true;
+      return 0;
+    }
+    return static_cast<uint8_t>(data_[pos_++]);
+  }
+
+  uint16_t u16()
+  {
+    uint16_t lo = u8();
+    return static_cast<uint16_t>(lo | (u8() << 8));
+  }
+
+  uint32_t u32()
+  {
+    uint32_t lo = u16();
+    return lo | (static_cast<uint32_t>(u16()) << 16);
+  }
+
+  double f64()
+  {
+    uint64_t lo = u32();
+    uint64_t bits = lo | (static_cast<uint64_t>(u32()) << 32);
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+
+  std::string_view bytes(std::size_t n)
+  {
+    if (n > data_.size() - pos_) {
+      failed_ = true;
+      pos_ = data_.size();
+      return {};
+    }
+    std::string_view v = data_.substr(pos_, n);
+    pos_ += n;
+    return v;
+  }
+
+  bool failed() const
+  {
+    return failed_;
+  }
+
+private:
+  std::string_view data_;
+  std::size_t pos_ = 0;
+  bool failed_ = false;
+};
+
+/// \endcond
+
+bool writeCalibrationBin(
+  std::ostream & out, const std::string & camera_name,
+  const CameraInfo & cam_info)
+{
+  if (camera_name.size() > std::numeric_limits<uint16_t>::max() ||
+    cam_info.distortion_model.size() > std::numeric_limits<uint16_t>::max() ||
+    cam_info.d.size() > std::numeric_limits<uint32_t>::max() / 8)
+  {
+    RCLCPP_ERROR(kBinLogger, "Camera calibration is too large for the binary format");
+    return false;
+  }
+
+  std::string buffer;
+  buffer.reserve(
+    kBinHeaderSize + kBinFixedPayloadSize + camera_name.size() +
+    cam_info.distortion_model.size() + 8 * cam_info.d.size());
+  BinWriter w(buffer);
+
+  // Header; payload size and checksum are filled in below.
+  w.bytes(kCalibrationBinMagic);
+  w.u16(kBinVersion);
+  w.u16(0);
+  w.u32(0);
+  w.u32(0);
+
+  w.u32(cam_info.width);
+  w.u32(cam_info.height);
+  w.u32(cam_info.binning_x);
+  w.u32(cam_info.binning_y);
+  w.u32(cam_info.roi.x_offset);
+  w.u32(cam_info.roi.y_offset);
+  w.u32(cam_info.roi.height);
+  w.u32(cam_info.roi.width);
+  w.u8(cam_info.roi.do_rectify ? 1 : 0);
+  w.u8(0);
+  w.u8(0);
+  w.u8(0);
+  for (double v : cam_info.k) {
+    w.f64(v);
+  }
+  for (double v : cam_info.r) {
+    w.f64(v);
+  }
+  for (double v : cam_info.p) {
+    w.f64(v);
+  }
+  w.u16(static_cast<uint16_t>(camera_name.size()));
+  w.u16(static_cast<uint16_t>(cam_info.distortion_model.size()));
+  w.u32(static_cast<uint32_t>(cam_info.d.size()));
+  w.bytes(camera_name);
+  w.bytes(cam_info.distortion_model);
+  for (double v : cam_info.d) {
+    w.f64(v);
+  }
+
+  std::string_view payload = std::string_view(buffer).substr(kBinHeaderSize);
+  std::string trailer;
+  BinWriter t(trailer);
+  t.u32(static_cast<uint32_t>(payload.size()));
+  t.u32(crc32(payload));
+  buffer.replace(8, trailer.size(), trailer);
+
+  out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  return out.good();
+}
+
+bool writeCalibrationBin(
+  const std::string & file_name, const std::string & camera_name,
+  const CameraInfo & cam_info)
+{
+  std::filesystem::path dir(std::filesystem::path(file_name).parent_path());
+  if (!dir.empty() && !std::filesystem::exists(dir) &&
+    !std::filesystem::create_directories(dir))
+  {
+    RCLCPP_ERROR(
+      kBinLogger, "Unable to create directory for camera calibration file [%s]",
+      dir.string().c_str());
+    return false;
+  }
+  std::ostringstream out(std::ios::binary);
+  if (!writeCalibrationBin(out, camera_name, cam_info)) {
+    return false;
+  }
+  // Replaced atomically, so a reader never sees a partial calibration.
+  std::string error;
+  if (!impl::replaceFile(file_name, out.str(), error)) {
+    RCLCPP_ERROR(
+      kBinLogger, "Unable to write camera calibration file [%s]: %s",
+      file_name.c_str(), error.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool parseCalibrationBin(
+  std::string_view buffer, std::string & camera_name,
+  CameraInfo & cam_info)
+{
+  if (buffer.size() < kBinHeaderSize || buffer.substr(0, 4) != kCalibrationBinMagic) {
+    RCLCPP_ERROR(kBinLogger, "Not a binary camera calibration");
+    return false;
+  }
+
+  BinReader header(buffer.substr(4, kBinHeaderSize - 4));
+  uint16_t version = header.u16();
+  uint16_t reserved = header.u16();
+  uint32_t payload_size = header.u32();
+  uint32_t checksum = header.u32();
+  if (version != kBinVersion) {
+    RCLCPP_ERROR(
+      kBinLogger, "Unsupported binary camera calibration version %u, expected %u",
+      static_cast<unsigned>(version), static_cast<unsigned>(kBinVersion));
+    return false;
+  }
+  if (reserved != 0) {
+    RCLCPP_ERROR(
+      kBinLogger, "Binary camera calibration has a nonzero reserved field (%u)",
+      static_cast<unsigned>(reserved));
+    return false;
+  }
+  if (payload_size > buffer.size() - kBinHeaderSize) {
+    RCLCPP_ERROR(
+      kBinLogger, "Binary camera calibration is truncated: %zu of %zu bytes",
+      buffer.size(), kBinHeaderSize + static_cast<std::size_t>(payload_size));
+    return false;
+  }
+  std::string_view payload = buffer.substr(kBinHeaderSize, payload_size);
+  if (crc32(payload) != checksum) {
+    RCLCPP_ERROR(kBinLogger, "Binary camera calibration is corrupt: checksum mismatch");
+    return false;
+  }
+
+  CameraInfo result;
+  BinReader r(payload);
+  result.width = r.u32();
+  result.height = r.u32();
+  result.binning_x = r.u32();
+  result.binning_y = r.u32();
+  result.roi.x_offset = r.u32();
+  result.roi.y_offset = r.u32();
+  result.roi.height = r.u32();
+  result.roi.width = r.u32();
+  result.roi.do_rectify = r.u8() != 0;
+  r.bytes(3);
+  for (double & v : result.k) {
+    v = r.f64();
+  }
+  for (double & v : result.r) {
+    v = r.f64();
+  }
+  for (double & v : result.p) {
+    v = r.f64();
+  }
+  uint16_t name_size = r.u16();
+  uint16_t model_size = r.u16();
+  uint32_t d_size = r.u32();
+  std::string_view name = r.bytes(name_size);
+  std::string_view model = r.bytes(model_size);
+  if (!r.failed() && d_size <= (payload.size() - kBinFixedPayloadSize) / 8) {
+    result.d.resize(d_size);
+    for (double & v : result.d) {
+      v = r.f64();
+    }
+  }
+  if (r.failed() || result.d.size() != d_size) {
+    RCLCPP_ERROR(kBinLogger, "Binary camera calibration is corrupt: inconsistent sizes");
+    return false;
+  }
+
+  result.header = cam_info.header;
+  result.distortion_model.assign(model.data(), model.size());
+  cam_info = std::move(result);
+  camera_name.assign(name.data(), name.size());
+  return true;
+}
+
+bool readCalibrationBin(
+  std::istream & in, std::string & camera_name,
+  CameraInfo & cam_info)
+{
+  const std::string buffer{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  return parseCalibrationBin(buffer, camera_name, cam_info);
+}
+
+bool readCalibrationBin(
+  const std::string & file_name, std::string & camera_name,
+  CameraInfo & cam_info)
+{
+  impl::MappedFile file(file_name);
+  if (!file.valid()) {
+    RCLCPP_ERROR(kBinLogger, "Unable to open camera calibration file [%s]", file_name.c_str());
+    return false;
+  }
+  if (!parseCalibrationBin(file.data(), camera_name, cam_info)) {
+    RCLCPP_ERROR(
+      kBinLogger, "Failed to parse camera calibration from file [%s]", file_name.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace camera_calibration_parsers
@@ -0,0 +1,428 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "camera_calibration_parsers/parse_bundle.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include "camera_calibration_parsers/parse_yml.hpp"
+#include "rclcpp/logging.hpp"
+
+#include "mapped_file.hpp"
+#include "replace_file.hpp"
+
+namespace camera_calibration_parsers
+{
+
+static rclcpp::Logger kBundleLogger = rclcpp::get_logger("camera_calibration_parsers");
+
+/// \cond
+
+static const char BUNDLE_MAGIC[] = "%CALIBRATION_BUNDLE";
+static const char BUNDLE_END[] = "\n%END\n";
+static const int BUNDLE_VERSION = 1;
+
+struct BundleRecord
+{
+  std::string camera;
+  size_t offset;
+  size_t size;
+};
+
+/// \endcond
+
+struct CalibrationBundle::Impl
+{
+  std::unique_ptr<impl::MappedFile> file;
+  std::string_view records;             // everything after the index
+  std::vector<BundleRecord> index;      // in file order
+  std::map<std::string, size_t> by_camera;
+
+  std::string_view record(const BundleRecord & r) const
+  {
+    return records.substr(r.offset, r.size);
+  }
+};
+
+static bool validBundleCamera(const std::string & camera)
+{
+  return !camera.empty() && std::all_of(
+    camera.begin(), camera.end(), [](char c) {
+      return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    });
+}
+
+static bool parseBundleIndex(
+  std::string_view data, std::vector<BundleRecord> & index,
+  size_t & records_start)
+{
+  size_t end = data.find(BUNDLE_END);
+  if (end == std::string_view::npos) {
+    return false;
+  }
+  std::istringstream in{std::string(data.substr(0, end))};
+  std::string magic;
+  int version;
+  size_t count;
+  if (!(in >> magic >> version >> count) || magic != BUNDLE_MAGIC ||
+    version != BUNDLE_VERSION)
+  {
+    return false;
+  }
+
+  records_start = end + sizeof(BUNDLE_END) - 1;
+  const size_t records_size = data.size() - records_start;
+  for (size_t i = 0; i < count; ++i) {
+    BundleRecord r;
+    if (!(in >> r.camera >> r.offset >> r.size) || !validBundleCamera(r.camera) ||
+      r.offset > records_size || r.size > records_size - r.offset)
+    {
+      return false;
+    }
+    index.push_back(std::move(r));
+  }
+  std::string extra;
+  return !(in >> extra);
+}
+
+static std::string encodeBundle(
+  const std::vector<std::pair<std::string, std::string_view>> & records)
+{
+  std::string out = std::string(BUNDLE_MAGIC) + " " + std::to_string(BUNDLE_VERSION) + " " +
+    std::to_string(records.size()) + "\n";
+  size_t offset = 0;
+  for (const auto & r : records) {
+    out += r.first + " " + std::to_string(offset) + " " + std::to_string(r.second.size()) + "\n";
+    offset += r.second.size();
+  }
+  out.pop_back();                       // BUNDLE_END starts with the newline
+  out += BUNDLE_END;
+  for (const auto & r : records) {
+    out.append(r.second.data(), r.second.size());
+  }
+  return out;
+}
+
+static bool createBundleDirectory(const std::string & file_name)
+{
+  std::filesystem::path dir(std::filesystem::path(file_name).parent_path());
+  std::error_code ec;
+  if (!dir.empty() && !std::filesystem::exists(dir, ec) &&
+    !std::filesystem::create_directories(dir, ec))
+  {
+    RCLCPP_ERROR(
+      kBundleLogger, "Unable to create directory for calibration bundle [%s]",
+      dir.string().c_str());
+    return false;
+  }
+  return true;
+}
+
+// One per bundle this process writes, never freed.
+static std::mutex & bundleMutex(const std::string & file_name)
+{
+  static std::mutex mutex;
+  static auto * mutexes = new std::map<std::string, std::unique_ptr<std::mutex>>;
+  std::error_code ec;
+  std::filesystem::path path = std::filesystem::absolute(file_name, ec);
+  if (ec) {
+    path = file_name;
+  }
+  const std::string key = path.lexically_normal().string();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto & bundle_mutex = (*mutexes)[key];
+  if (!bundle_mutex) {
+    bundle_mutex = std::make_unique<std::mutex>();
+  }
+  return *bundle_mutex;
+}
+
+/// \cond
+
+// Serializes the read, update and replace of a bundle: between threads with a mutex per
+// bundle, and between processes with flock() on "<bundle>.lock". The bundle itself cannot
+// carry the lock, it is replaced on every write.
+class BundleWriteLock
+{
+public:
+  explicit BundleWriteLock(const std::string & file_name)
+  : lock_(bundleMutex(file_name))
+  {
+#ifndef _WIN32
+    const std::string lock_name = file_name + ".lock";
+    fd_ = ::open(lock_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    int result = fd_ < 0 ? -1 : flock(fd_, LOCK_EX);
+    while (result != 0 && fd_ >= 0 && errno == EINTR) {
+      result = flock(fd_, LOCK_EX);
+    }
+    if (result != 0) {
+      RCLCPP_ERROR(
+        kBundleLogger, "Unable to lock calibration bundle [%s]: %s",
+        lock_name.c_str(), strerror(errno));
+      if (fd_ >= 0) {
+        ::close(fd_);
+      }
+      fd_ = -1;
+      locked_ = false;
+    }
+#endif
+  }
+
+  ~BundleWriteLock()
+  {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+      ::close(fd_);                     // releases the flock()
+    }
+#endif
+  }
+
+  BundleWriteLock(const BundleWriteLock &) = delete;
+  BundleWriteLock & operator=(const BundleWriteLock &) = delete;
+
+  bool locked() const
+  {
+    return locked_;
+  }
+
+private:
+  std::lock_guard<std::mutex> lock_;
+  int fd_ = -1;
+  bool locked_ = true;
+};
+
+/// \endcond
+
+// Write a new temporary file next to the bundle, then replace the bundle in one step.
+static bool writeBundleFile(const std::string & file_name, const std::string & contents)
+{
+  std::string error;
+  if (!impl::replaceFile(file_name, contents, error)) {
+    RCLCPP_ERROR(
+      kBundleLogger, "Unable to write calibration bundle [%s]: %s",
+      file_name.c_str(), error.c_str());
+    return false;
+  }
+  return true;
+}
+
+static std::string encodeBundleRecord(
+  const std::string & camera_name, const CameraInfo & cam_info)
+{
+  std::ostringstream out;
+  writeCalibrationYml(out, camera_name, cam_info);
+  out << "\n";
+  return out.str();
+}
+
+std::shared_ptr<const CalibrationBundle> CalibrationBundle::open(const std::string & file_name)
+{
+  auto bundle_impl = std::make_shared<Impl>();
+  bundle_impl->file = std::make_unique<impl::MappedFile>(file_name);
+  if (!bundle_impl->file->valid()) {
+    RCLCPP_ERROR(kBundleLogger, "Unable to open calibration bundle [%s]", file_name.c_str());
+    return nullptr;
+  }
+
+  std::string_view data = bundle_impl->file->data();
+  size_t records_start = 0;
+  bool valid = parseBundleIndex(data, bundle_impl->index, records_start);
+  for (size_t i = 0; valid && i < bundle_impl->index.size(); ++i) {
+    valid = bundle_impl->by_camera.emplace(bundle_impl->index[i].camera, i).second;
+  }
+  if (!valid) {
+    RCLCPP_ERROR(kBundleLogger, "Invalid calibration bundle [%s]", file_name.c_str());
+    return nullptr;
+  }
+  bundle_impl->records = data.substr(records_start);
+
+  std::shared_ptr<CalibrationBundle> bundle(new CalibrationBundle);
+  bundle->impl_ = bundle_impl;
+  return bundle;
+}
+
+std::vector<std::string> CalibrationBundle::cameras() const
+{
+  std::vector<std::string> cameras;
+  cameras.reserve(impl_->index.size());
+  for (const auto & r : impl_->index) {
+    cameras.push_back(r.camera);
+  }
+  return cameras;
+}
+
+bool CalibrationBundle::has(const std::string & camera) const
+{
+  return impl_->by_camera.count(camera) > 0;
+}
+
+std::string_view CalibrationBundle::record(const std::string & camera) const
+{
+  auto it = impl_->by_camera.find(camera);
+  if (it == impl_->by_camera.end()) {
+    return std::string_view();
+  }
+  return impl_->record(impl_->index[it->second]);
+}
+
+bool CalibrationBundle::read(
+  const std::string & camera, std::string & camera_name,
+  CameraInfo & cam_info) const
+{
+  auto it = impl_->by_camera.find(camera);
+  if (it == impl_->by_camera.end()) {
+    RCLCPP_ERROR(kBundleLogger, "Camera [%s] not found in calibration bundle", camera.c_str());
+    return false;
+  }
+  return parseCalibrationYml(impl_->record(impl_->index[it->second]), camera_name, cam_info);
+}
+
+bool CalibrationBundle::readAll(std::map<std::string, CameraInfo> & cam_infos) const
+{
+  std::string camera_name;
+  for (const auto & r : impl_->index) {
+    if (!parseCalibrationYml(impl_->record(r), camera_name, cam_infos[r.camera])) {
+      RCLCPP_ERROR(
+        kBundleLogger, "Failed to parse calibration of camera [%s] in bundle",
+        r.camera.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool readCalibrationBundle(
+  const std::string & file_name, const std::string & camera,
+  std::string & camera_name, CameraInfo & cam_info)
+{
+  auto bundle = CalibrationBundle::open(file_name);
+  return bundle && bundle->read(camera, camera_name, cam_info);
+}
+
+bool readCalibrationBundle(
+  const std::string & file_name, std::map<std::string, CameraInfo> & cam_infos)
+{
+  auto bundle = CalibrationBundle::open(file_name);
+  return bundle && bundle->readAll(cam_infos);
+}
+
+bool writeCalibrationBundle(
+  const std::string & file_name, const std::string & camera,
+  const std::string & camera_name, const CameraInfo & cam_info)
+{
+  if (!validBundleCamera(camera)) {
+    RCLCPP_ERROR(kBundleLogger, "Invalid calibration bundle camera [%s]", camera.c_str());
+    return false;
+  }
+  const std::string record = encodeBundleRecord(camera_name, cam_info);
+  if (!createBundleDirectory(file_name)) {
+    return false;
+  }
+  // Held until the bundle is replaced, so concurrent updates of other cameras are not lost.
+  BundleWriteLock lock(file_name);
+  if (!lock.locked()) {
+    return false;
+  }
+
+  // Never replace a file that is not a bundle.
+  std::shared_ptr<const CalibrationBundle> existing;
+  std::error_code ec;
+  if (std::filesystem::exists(file_name, ec)) {
+    existing = CalibrationBundle::open(file_name);
+    if (!existing) {
+      return false;
+    }
+  }
+
+  std::vector<std::pair<std::string, std::string_view>> records;
+  bool replaced = false;
+  if (existing) {
+    for (const auto & other : existing->cameras()) {
+      if (other != camera) {
+        records.emplace_back(other, existing->record(other));
+      } else if (existing->record(other) == record) {
+        return true;                    // unchanged
+      } else {
+        records.emplace_back(camera, record);
+        replaced = true;
+      }
+    }
+  }
+  if (!replaced) {
+    records.emplace_back(camera, record);
+  }
+  return writeBundleFile(file_name, encodeBundle(records));
+}
+
+bool writeCalibrationBundle(
+  const std::string & file_name, const std::map<std::string, CameraInfo> & cam_infos)
+{
+  std::vector<std::string> encoded;
+  encoded.reserve(cam_infos.size());
+  std::vector<std::pair<std::string, std::string_view>> records;
+  for (const auto & entry : cam_infos) {
+    if (!validBundleCamera(entry.first)) {
+      RCLCPP_ERROR(
+        kBundleLogger, "Invalid calibration bundle camera [%s]", entry.first.c_str());
+      return false;
+    }
+    encoded.push_back(encodeBundleRecord(entry.first, entry.second));
+    records.emplace_back(entry.first, encoded.back());
+  }
+  if (!createBundleDirectory(file_name)) {
+    return false;
+  }
+  BundleWriteLock lock(file_name);
+  return lock.locked() && writeBundleFile(file_name, encodeBundle(records));
+}
+
+}  // namespace camera_calibration_parsers
@@ -36,235 +36,162 @@
 
 #include "camera_calibration_parsers/parse_ini.hpp"
 
-#include <cassert>
-#include <cctype>
-#include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <filesystem>
 #include <fstream>
-#include <limits>
-#include <sstream>
+#include <iterator>
 #include <string>
-#include <vector>
+#include <string_view>
+#include <system_error>
 
 #include "rclcpp/logging.hpp"
 #include "sensor_msgs/distortion_models.hpp"
 
+#include "mapped_file.hpp"
+#include "number_format.hpp"
+
 namespace camera_calibration_parsers
 {
 
 static rclcpp::Logger kIniLogger = rclcpp::get_logger("camera_calibration_parsers");
 
-struct SimpleMatrix
-{
-  int rows;
-  int cols;
-  const double * data;
-
-  SimpleMatrix(int rows, int cols, const double * data)
-  : rows(rows), cols(cols), data(data)
-  {}
-};
+/// \cond
 
-std::ostream & operator<<(std::ostream & out, const SimpleMatrix & m)
+// Append a matrix as rows of space separated numbers.
+static void append_matrix(std::string & out, int rows, int cols, const double * data)
 {
-  for (int i = 0; i < m.rows; ++i) {
-    for (int j = 0; j < m.cols; ++j) {
-      out << m.data[m.cols * i + j] << " ";
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      impl::appendNumber(out, data[cols * i + j]);
+      out += ' ';
     }
-    out << std::endl;
+    out += '\n';
   }
-  return out;
-}
-
-// Remove whitespace from both ends of a string.
-void trim(std::string & s)
-{
-  s.erase(
-    s.begin(), std::find_if(
-      s.begin(), s.end(), [](int ch) {
-        return !std::isspace(ch);
-      }));
-  s.erase(
-    std::find_if(
-      s.rbegin(), s.rend(), [](int ch) {
-        return !std::isspace(ch);
-      }).base(), s.end());
 }
 
-// Determine if a given string is an INI section header
-bool is_section(const std::string & line)
+// Forward-only cursor over the significant lines of an INI buffer: trimmed, with blank
+// lines and '#' or ';' comments skipped. Keeps the line number for error messages.
+class IniCursor
 {
-  return line.find('[') != std::string::npos && line.find(']') != std::string::npos;
-}
-
-// Split input into lines.
-std::vector<std::string> split_lines(std::istream & input)
-{
-  std::vector<std::string> lines;
-  std::string line;
-  while (std::getline(input, line)) {
-    lines.push_back(line);
-  }
-  return lines;
-}
+public:
+  explicit IniCursor(std::string_view text)
+  : text_(text)
+  {}
 
-// Split lines into sections
-std::vector<std::vector<std::string>> split_sections(
-  const std::vector<std::string> & lines)
-{
-  std::vector<std::vector<std::string>> sections;
-  std::vector<std::string> section;
-  for (size_t ii = 0; ii < lines.size(); ++ii) {
-    std::string line = lines[ii];
-    trim(line);
-
-    // Skip empty lines.
-    if (line.length() == 0) {
-      continue;
+  bool next(std::string_view & line)
+  {
+    while (pos_ < text_.size()) {
+      std::size_t end = text_.find('\n', pos_);
+      if (end == std::string_view::npos) {
+        end = text_.size();
+      }
+      line = trim(text_.substr(pos_, end - pos_));
+      pos_ = end + 1;
+      ++line_number_;
+      if (!line.empty() && line[0] != '#' && line[0] != ';') {
+        return true;
+      }
     }
+    return false;
+  }
 
-    // Skip lines that are comments
-    if (line[0] == '#' || line[0] == ';') {
-      continue;
-    }
+  std::size_t lineNumber() const
+  {
+    return line_number_;
+  }
 
-    if (is_section(line) && section.size() > 0) {
-      sections.push_back(section);
-      section.clear();
+private:
+  static std::string_view trim(std::string_view s)
+  {
+    static constexpr char kSpace[] = " \t\r\v\f";
+    std::size_t first = s.find_first_not_of(kSpace);
+    if (first == std::string_view::npos) {
+      return {};
     }
-    section.push_back(line);
-  }
-  // Push the remaining content
-  if (section.size() > 0) {
-    sections.push_back(section);
+    return s.substr(first, s.find_last_not_of(kSpace) - first + 1);
   }
 
-  return sections;
+  std::string_view text_;
+  std::size_t pos_ = 0;
+  std::size_t line_number_ = 0;
+};
+
+// Determine if a given line is an INI section header
+static bool is_section(std::string_view line)
+{
+  return line.size() >= 2 && line.front() == '[' && line.back() == ']';
 }
 
-template<size_t rows, size_t cols>
-std::array<double, rows * cols> parse_matrix(std::vector<std::string>::const_iterator & begin)
+// Parse whitespace separated numbers from one line into out, up to max_count of them.
+// Returns the number of values read, or max_count + 1 if the line holds anything else.
+static std::size_t parse_row(std::string_view line, double * out, std::size_t max_count)
 {
-  std::array<double, rows * cols> ret;
-  for (size_t ii = 0; ii < rows; ++ii) {
-    auto ss = std::stringstream(*(begin++));
-    for (size_t jj = 0; jj < cols; ++jj) {
-      double val = std::numeric_limits<double>::quiet_NaN();
-      if (!ss.eof()) {
-        ss >> val;
-      }
-      ret[ii * cols + jj] = val;
+  std::size_t count = 0;
+  std::size_t pos = 0;
+  while ((pos = line.find_first_not_of(" \t", pos)) != std::string_view::npos) {
+    std::size_t end = std::min(line.find_first_of(" \t", pos), line.size());
+    std::string_view token = line.substr(pos, end - pos);
+    pos = end;
+    if (token.size() > 1 && token[0] == '+') {
+      token.remove_prefix(1);
     }
+    if (count == max_count) {
+      return max_count + 1;
+    }
+    auto result = std::from_chars(token.data(), token.data() + token.size(), out[count]);
+    if (result.ec != std::errc() || result.ptr != token.data() + token.size()) {
+      return max_count + 1;
+    }
+    ++count;
   }
-  return ret;
+  return count;
 }
 
-bool parse_image_section(const std::vector<std::string> & section, CameraInfo & cam_info)
+// Read the value lines following a matrix key. Every row must hold exactly cols numbers.
+static bool parse_matrix(
+  IniCursor & cursor, const char * key, std::size_t rows, std::size_t cols, double * out)
 {
-  auto width = std::find(section.begin(), section.end(), "width");
-  if (width == section.end()) {
-    RCLCPP_ERROR(kIniLogger, "Failed to find key 'width' in section '[image]'");
-    return false;
-  }
-
-  auto height = std::find(section.begin(), section.end(), "height");
-  if (height == section.end()) {
-    RCLCPP_ERROR(kIniLogger, "Failed to find key 'height' in section '[image]'");
-    return false;
+  for (std::size_t ii = 0; ii < rows; ++ii) {
+    std::string_view line;
+    if (!cursor.next(line)) {
+      RCLCPP_ERROR(
+        kIniLogger, "Error parsing '%s', expected %zu rows but the file ends after %zu",
+        key, rows, ii);
+      return false;
+    }
+    if (parse_row(line, out + ii * cols, cols) != cols) {
+      RCLCPP_ERROR(
+        kIniLogger, "Error parsing '%s', incorrect size: line %zu should hold %zu numbers: '%.*s'",
+        key, cursor.lineNumber(), cols, static_cast<int>(line.size()), line.data());
+      return false;
+    }
   }
-
-  cam_info.width = stoi(*(++width));
-  cam_info.height = stoi(*(++height));
   return true;
 }
 
-bool parse_camera_section(
-  const std::vector<std::string> & section,
-  std::string & camera_name,
-  CameraInfo & cam_info)
+static bool parse_unsigned(IniCursor & cursor, const char * key, uint32_t & out)
 {
-  camera_name = std::string(section[0].begin() + 1, section[0].end() - 1);
-
-  auto camera_matrix = std::find(section.begin(), section.end(), "camera matrix");
-  if (camera_matrix == section.end()) {
-    RCLCPP_ERROR(kIniLogger, "Failed to find key 'camera matrix' in camera section");
-    return false;
-  }
-
-  auto distortion = std::find(section.begin(), section.end(), "distortion");
-  if (distortion == section.end()) {
-    RCLCPP_ERROR(kIniLogger, "Failed to find key 'distortion' in camera section");
+  std::string_view line;
+  if (!cursor.next(line)) {
+    RCLCPP_ERROR(kIniLogger, "Error parsing '%s', the file ends before its value", key);
     return false;
   }
-
-  auto rectification = std::find(section.begin(), section.end(), "rectification");
-  if (rectification == section.end()) {
-    RCLCPP_ERROR(kIniLogger, "Failed to find key 'rectification' in camera section");
-    return false;
-  }
-
-  auto projection = std::find(section.begin(), section.end(), "projection");
-  if (projection == section.end()) {
-    RCLCPP_ERROR(kIniLogger, "Failed to find key 'projection' in camera section");
-    return false;
-  }
-
-  auto d = parse_matrix<1, 8>(++distortion);
-  if (std::isnan(d[5])) {
-    cam_info.d = std::vector<double>(d.begin(), d.begin() + 5);
-    cam_info.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
-  } else {
-    cam_info.d = std::vector<double>(d.begin(), d.end());
-    cam_info.distortion_model = sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL;
-  }
-
-  auto array_has_nan = [](auto a) {
-      return std::end(a) != std::find_if(
-        std::begin(a), std::end(a), [](double v) {
-          return std::isnan(v);
-        });
-    };
-
-  cam_info.k = parse_matrix<3, 3>(++camera_matrix);
-  if (array_has_nan(cam_info.k)) {
-    RCLCPP_ERROR(kIniLogger, "Error parsing 'camera matrix', incorrect size");
-    return false;
-  }
-
-  cam_info.r = parse_matrix<3, 3>(++rectification);
-  if (array_has_nan(cam_info.r)) {
-    RCLCPP_ERROR(kIniLogger, "Error parsing 'rectification', incorrect size");
-    return false;
-  }
-
-  cam_info.p = parse_matrix<3, 4>(++projection);
-  if (array_has_nan(cam_info.p)) {
-    RCLCPP_ERROR(kIniLogger, "Error parsing 'projection', incorrect size");
+  auto result = std::from_chars(line.data(), line.data() + line.size(), out);
+  if (result.ec != std::errc() || result.ptr != line.data() + line.size()) {
+    RCLCPP_ERROR(
+      kIniLogger, "Error parsing '%s' on line %zu, expected an unsigned integer: '%.*s'",
+      key, cursor.lineNumber(), static_cast<int>(line.size()), line.data());
     return false;
   }
   return true;
 }
 
-
-bool parse_externals_section(const std::vector<std::string> & section)
-{
-  auto translation = std::find(section.begin(), section.end(), "translation");
-  if (translation == section.end()) {
-    RCLCPP_ERROR(kIniLogger, "Failed to find key 'translation' in section '[externals]'");
-    // Don't error, because nothing is done with this anyway
-  }
-
-  auto rotation = std::find(section.begin(), section.end(), "rotation");
-  if (rotation == section.end()) {
-    RCLCPP_ERROR(kIniLogger, "Failed to find key 'rotation' in section '[externals]'");
-    // Don't error, because nothing is done with this anyway
-  }
-
-  return true;
-}
+/// \endcond
 
 bool writeCalibrationIni(
   std::ostream & out, const std::string & camera_name,
@@ -286,22 +213,32 @@ bool writeCalibrationIni(
     return false;
   }
 
-  out.precision(5);
-  out << std::fixed;
+  // Shortest round-trip formatting, so reading the file back gives bit-identical values.
+  std::string text;
+  text.reserve(1024);
 
-  out << "# Camera intrinsics\n\n";
+  text += "# Camera intrinsics\n\n";
   /// @todo time?
-  out << "[image]\n\n";
-  out << "width\n" << cam_info.width << "\n\n";
-  out << "height\n" << cam_info.height << "\n\n";
-  out << "[" << camera_name << "]\n\n";
-
-  out << "camera matrix\n" << SimpleMatrix(3, 3, &cam_info.k[0]);
-  out << "\ndistortion\n" << SimpleMatrix(1, 5, &cam_info.d[0]);
-  out << "\n\nrectification\n" << SimpleMatrix(3, 3, &cam_info.r[0]);
-  out << "\nprojection\n" << SimpleMatrix(3, 4, &cam_info.p[0]);
-
-  return true;
+  text += "[image]\n\n";
+  text += "width\n";
+  impl::appendNumber(text, cam_info.width);
+  text += "\n\nheight\n";
+  impl::appendNumber(text, cam_info.height);
+  text += "\n\n[";
+  text += camera_name;
+  text += "]\n\n";
+
+  text += "camera matrix\n";
+  append_matrix(text, 3, 3, cam_info.k.data());
+  text += "\ndistortion\n";
+  append_matrix(text, 1, 5, cam_info.d.data());
+  text += "\n\nrectification\n";
+  append_matrix(text, 3, 3, cam_info.r.data());
+  text += "\nprojection\n";
+  append_matrix(text, 3, 4, cam_info.p.data());
+
+  out.write(text.data(), static_cast<std::streamsize>(text.size()));
+  return out.good();
 }
 
 bool writeCalibrationIni(
@@ -332,50 +269,188 @@ bool readCalibrationIni(
   std::istream & in, std::string & camera_name,
   CameraInfo & cam_info)
 {
-  auto lines = split_lines(in);
-  if (lines.size() == 0) {
-    RCLCPP_ERROR(kIniLogger, "Failed to detect content in .ini file");
-    return false;
-  }
-
-  auto sections = split_sections(lines);
-  if (sections.size() == 0) {
-    RCLCPP_ERROR(kIniLogger, "Failed to detect valid sections in .ini file");
-    return false;
-  }
-
-  for (auto section : sections) {
-    if (section[0] == "[image]") {
-      if (!parse_image_section(section, cam_info)) {
-        return false;
-      }
-    } else if (section[0] == "[externals]") {
-      if (!parse_externals_section(section)) {
-        return false;
-      }
-    } else {
-      if (!parse_camera_section(section, camera_name, cam_info)) {
-        return false;
-      }
-    }
-  }
-  return true;
+  std::string buffer{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  return parseCalibrationIni(std::string_view(buffer), camera_name, cam_info);
 }
 
 bool readCalibrationIni(
   const std::string & file_name, std::string & camera_name,
   CameraInfo & cam_info)
 {
-  std::fstream fs(file_name);
-  return readCalibrationIni(fs, camera_name, cam_info);
+  impl::MappedFile file(file_name);
+  if (!file.valid()) {
+    RCLCPP_ERROR(kIniLogger, "Unable to open camera calibration file [%s]", file_name.c_str());
+    return false;
+  }
+  return parseCalibrationIni(file.data(), camera_name, cam_info);
 }
 
 bool parseCalibrationIni(
   const std::string & buffer, std::string & camera_name,
   CameraInfo & cam_info)
 {
-  std::stringstream ss(buffer);
-  return readCalibrationIni(ss, camera_name, cam_info);
+  return parseCalibrationIni(std::string_view(buffer), camera_name, cam_info);
+}
+
+bool parseCalibrationIni(
+  std::string_view buffer, std::string & camera_name,
+  CameraInfo & cam_info)
+{
+  enum class Section { None, Image, Externals, Camera };
+  enum Key : unsigned
+  {
+    kWidth = 1u << 0, kHeight = 1u << 1,
+    kTranslation = 1u << 2, kRotation = 1u << 3,
+    kCameraMatrix = 1u << 4, kDistortion = 1u << 5, kRectification = 1u << 6,
+    kProjection = 1u << 7,
+  };
+
+  // Everything is parsed into locals, so cam_info is only touched on success.
+  uint32_t width = cam_info.width;
+  uint32_t height = cam_info.height;
+  std::string_view name;
+  std::array<double, 9> k{}, r{};
+  std::array<double, 12> p{};
+  std::array<double, 8> d{};
+  std::size_t d_count = 0;
+  bool have_camera = false;
+
+  Section section = Section::None;
+  unsigned keys = 0;
+  std::size_t sections = 0;
+
+  // Verify the section that just ended had all of its keys.
+  auto finish_section = [&]() -> bool {
+      auto require = [&](unsigned key, const char * key_name, const char * where) {
+          if (!(keys & key)) {
+            RCLCPP_ERROR(kIniLogger, "Failed to find key '%s' in %s", key_name, where);
+            return false;
+          }
+          return true;
+        };
+      switch (section) {
+        case Section::Image:
+          return require(kWidth, "width", "section '[image]'") &&
+                 require(kHeight, "height", "section '[image]'");
+        case Section::Externals:
+          // Don't error, because nothing is done with this anyway
+          require(kTranslation, "translation", "section '[externals]'");
+          require(kRotation, "rotation", "section '[externals]'");
+          return true;
+        case Section::Camera:
+          return require(kCameraMatrix, "camera matrix", "camera section") &&
+                 require(kDistortion, "distortion", "camera section") &&
+                 require(kRectification, "rectification", "camera section") &&
+                 require(kProjection, "projection", "camera section");
+        case Section::None:
+          break;
+      }
+      return true;
+    };
+
+  IniCursor cursor(buffer);
+  std::string_view line;
+  while (cursor.next(line)) {
+    if (is_section(line)) {
+      if (!finish_section()) {
+        return false;
+      }
+      keys = 0;
+      ++sections;
+      if (line == "[image]") {
+        section = Section::Image;
+      } else if (line == "[externals]") {
+        section = Section::Externals;
+      } else {
+        section = Section::Camera;
+        name = line.substr(1, line.size() - 2);
+        have_camera = true;
+      }
+      continue;
+    }
+
+    bool ok = true;
+    unsigned key = 0;
+    switch (section) {
+      case Section::Image:
+        if (line == "width") {
+          key = kWidth;
+          ok = parse_unsigned(cursor, "width", width);
+        } else if (line == "height") {
+          key = kHeight;
+          ok = parse_unsigned(cursor, "height", height);
+        }
+        break;
+      case Section::Externals:
+        if (line == "translation") {
+          key = kTranslation;
+        } else if (line == "rotation") {
+          key = kRotation;
+        }
+        break;
+      case Section::Camera:
+        if (line == "camera matrix") {
+          key = kCameraMatrix;
+          ok = parse_matrix(cursor, "camera matrix", 3, 3, k.data());
+        } else if (line == "distortion") {
+          key = kDistortion;
+          std::string_view row;
+          if (!cursor.next(row)) {
+            RCLCPP_ERROR(kIniLogger, "Error parsing 'distortion', the file ends before its value");
+            return false;
+          }
+          d_count = parse_row(row, d.data(), d.size());
+          if (d_count != 5 && d_count != 8) {
+            RCLCPP_ERROR(
+              kIniLogger, "Error parsing 'distortion' on line %zu, expected 5 or 8 numbers: '%.*s'",
+              cursor.lineNumber(), static_cast<int>(row.size()), row.data());
+            return false;
+          }
+        } else if (line == "rectification") {
+          key = kRectification;
+          ok = parse_matrix(cursor, "rectification", 3, 3, r.data());
+        } else if (line == "projection") {
+          key = kProjection;
+          ok = parse_matrix(cursor, "projection", 3, 4, p.data());
+        }
+        break;
+      case Section::None:
+        RCLCPP_ERROR(
+          kIniLogger, "Line %zu is outside of any section: '%.*s'",
+          cursor.lineNumber(), static_cast<int>(line.size()), line.data());
+        return false;
+    }
+    if (!ok) {
+      return false;
+    }
+    keys |= key;
+  }
+
+  if (buffer.find_first_not_of(" \t\r\n") == std::string_view::npos) {
+    RCLCPP_ERROR(kIniLogger, "Failed to detect content in .ini file");
+    return false;
+  }
+  if (sections == 0) {
+    RCLCPP_ERROR(kIniLogger, "Failed to detect valid sections in .ini file");
+    return false;
+  }
+  if (!finish_section()) {
+    return false;
+  }
+
+  cam_info.width = width;
+  cam_info.height = height;
+  if (have_camera) {
+    camera_name.assign(name.data(), name.size());
+    cam_info.k = k;
+    cam_info.r = r;
+    cam_info.p = p;
+    cam_info.d.assign(d.begin(), d.begin() + d_count);
+    cam_info.distortion_model = d_count == 5 ?
+      sensor_msgs::distortion_models::PLUMB_BOB :
+      sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL;
+  }
+  return true;
 }
 
 }  // namespace camera_calibration_parsers
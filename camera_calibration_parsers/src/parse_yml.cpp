@@ -34,17 +34,22 @@
 
 #include "camera_calibration_parsers/parse_yml.hpp"
 
-#include <cassert>
+#include <cmath>
 #include <cstring>
-#include <ctime>
 
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <string>
+#include <utility>
 
 #include "rclcpp/logging.hpp"
 #include "sensor_msgs/distortion_models.hpp"
 
+#include "mapped_file.hpp"
+#include "number_format.hpp"
+#include "parse_yml_stream.hpp"
+
 #ifdef _WIN32
 // TODO(mjcarroll): This shouldn't be needed, but there are some issues
 // with MSVC and YAML-CPP that are upstream causing warnings in CI.
@@ -92,40 +97,111 @@ struct SimpleMatrix
   {}
 };
 
-YAML::Emitter & operator<<(YAML::Emitter & out, const SimpleMatrix & m)
-{
-  out << YAML::BeginMap;
-  out << YAML::Key << "rows" << YAML::Value << m.rows;
-  out << YAML::Key << "cols" << YAML::Value << m.cols;
-  // out << YAML::Key << "dt"   << YAML::Value << "d"; // OpenCV data type specifier
-  out << YAML::Key << "data" << YAML::Value;
-  out << YAML::Flow;
-  out << YAML::BeginSeq;
-  for (int i = 0; i < m.rows * m.cols; ++i) {
-    out << m.data[i];
-  }
-  out << YAML::EndSeq;
-  out << YAML::EndMap;
-  return out;
-}
-
 template<typename T>
 void operator>>(const YAML::Node & node, T & i)
 {
   i = node.as<T>();
 }
 
-void operator>>(const YAML::Node & node, SimpleMatrix & m)
+// Read the shape of a matrix node and check that its data holds that many values.
+static bool readMatrixShape(const YAML::Node & node, const char * name, int & rows, int & cols)
 {
-  int rows, cols;
   node["rows"] >> rows;
-  assert(rows == m.rows);
   node["cols"] >> cols;
-  assert(cols == m.cols);
+  const YAML::Node & data = node["data"];
+  const size_t size = data.IsSequence() ? data.size() : 0;
+  if (rows < 0 || cols < 0 || size < static_cast<size_t>(rows) * static_cast<size_t>(cols)) {
+    RCLCPP_ERROR(
+      kYmlLogger, "Invalid '%s' in YAML camera calibration: %d x %d matrix with %zu values",
+      name, rows, cols, size);
+    return false;
+  }
+  return true;
+}
+
+static bool readMatrix(const YAML::Node & node, const char * name, SimpleMatrix & m)
+{
+  int rows, cols;
+  if (!readMatrixShape(node, name, rows, cols)) {
+    return false;
+  }
+  if (rows != m.rows || cols != m.cols) {
+    RCLCPP_ERROR(
+      kYmlLogger, "Invalid '%s' in YAML camera calibration: expected %d x %d, got %d x %d",
+      name, m.rows, m.cols, rows, cols);
+    return false;
+  }
   const YAML::Node & data = node["data"];
   for (int i = 0; i < rows * cols; ++i) {
     data[i] >> m.data[i];
   }
+  return true;
+}
+
+// Scalars that read back verbatim without quoting; anything else goes through yaml-cpp.
+static bool isPlainScalar(const std::string & value)
+{
+  if (value.empty() || value == "null" || value == "Null" || value == "NULL") {
+    return false;
+  }
+  for (char c : value) {
+    bool plain = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+      (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '/' || c == '-';
+    if (!plain) {
+      return false;
+    }
+  }
+  return value[0] != '-' && value[0] != '.';
+}
+
+static void appendScalar(std::string & out, const std::string & value)
+{
+  if (isPlainScalar(value)) {
+    out += value;
+  } else {
+    YAML::Emitter emitter;
+    emitter << value;
+    out += emitter.c_str();
+  }
+}
+
+static void appendDouble(std::string & out, double value)
+{
+  if (std::isnan(value)) {
+    out += ".nan";
+  } else if (std::isinf(value)) {
+    out += value < 0 ? "-.inf" : ".inf";
+  } else {
+    impl::appendNumber(out, value);
+  }
+}
+
+static void appendMatrix(
+  std::string & out, const char * name, int rows, int cols, const double * data)
+{
+  out += name;
+  out += ":\n  rows: ";
+  impl::appendNumber(out, rows);
+  out += "\n  cols: ";
+  impl::appendNumber(out, cols);
+  out += "\n  data: [";
+  for (int i = 0; i < rows * cols; ++i) {
+    if (i > 0) {
+      out += ", ";
+    }
+    appendDouble(out, data[i]);
+  }
+  out += "]\n";
+}
+
+template<typename T>
+static void appendKey(std::string & out, const char * name, T value, const char * indent = "")
+{
+  out += indent;
+  out += name;
+  out += ": ";
+  impl::appendNumber(out, value);
+  out += '\n';
 }
 
 /// \endcond
@@ -134,54 +210,46 @@ bool writeCalibrationYml(
   std::ostream & out, const std::string & camera_name,
   const CameraInfo & cam_info)
 {
-  YAML::Emitter emitter;
-  emitter << YAML::BeginMap;
-
-#if 0
-  // Calibration time
-  /// @todo Emitting the time breaks yaml-cpp on reading for some reason
-  time_t raw_time;
-  time(&raw_time);
-  emitter << YAML::Key << "calibration_time";
-  emitter << YAML::Value << asctime_r(localtime_r(&raw_time));
-#endif
+  // Same layout as yaml-cpp's block emitter with flow sequences for matrix data, formatted
+  // directly so that doubles use the shortest representation that reads back exactly.
+  std::string text;
+  text.reserve(1024);
 
   // Image dimensions
-  emitter << YAML::Key << WIDTH_YML_NAME << YAML::Value << static_cast<int>(cam_info.width);
-  emitter << YAML::Key << HEIGHT_YML_NAME << YAML::Value << static_cast<int>(cam_info.height);
+  appendKey(text, WIDTH_YML_NAME, cam_info.width);
+  appendKey(text, HEIGHT_YML_NAME, cam_info.height);
 
   // Camera name and intrinsics
-  emitter << YAML::Key << CAM_YML_NAME << YAML::Value << camera_name;
-  emitter << YAML::Key << K_YML_NAME << YAML::Value <<
-    SimpleMatrix(3, 3, const_cast<double *>(&cam_info.k[0]));
-  emitter << YAML::Key << DMODEL_YML_NAME << YAML::Value << cam_info.distortion_model;
-  emitter << YAML::Key << D_YML_NAME << YAML::Value << SimpleMatrix(
-    1,
-    static_cast<int>(cam_info.d.size()),
-    const_cast<double *>(&cam_info.d[0]));
-  emitter << YAML::Key << R_YML_NAME << YAML::Value <<
-    SimpleMatrix(3, 3, const_cast<double *>(&cam_info.r[0]));
-  emitter << YAML::Key << P_YML_NAME << YAML::Value <<
-    SimpleMatrix(3, 4, const_cast<double *>(&cam_info.p[0]));
+  text += CAM_YML_NAME;
+  text += ": ";
+  appendScalar(text, camera_name);
+  text += '\n';
+  appendMatrix(text, K_YML_NAME, 3, 3, cam_info.k.data());
+  text += DMODEL_YML_NAME;
+  text += ": ";
+  appendScalar(text, cam_info.distortion_model);
+  text += '\n';
+  appendMatrix(text, D_YML_NAME, 1, static_cast<int>(cam_info.d.size()), cam_info.d.data());
+  appendMatrix(text, R_YML_NAME, 3, 3, cam_info.r.data());
+  appendMatrix(text, P_YML_NAME, 3, 4, cam_info.p.data());
 
   // Binning
-  emitter << YAML::Key << BINNING_X_YML_NAME << YAML::Value << cam_info.binning_x;
-  emitter << YAML::Key << BINNING_Y_YML_NAME << YAML::Value << cam_info.binning_y;
+  appendKey(text, BINNING_X_YML_NAME, cam_info.binning_x);
+  appendKey(text, BINNING_Y_YML_NAME, cam_info.binning_y);
 
   // ROI
-  emitter << YAML::Key << ROI_YML_NAME << YAML::Value;
-  emitter << YAML::BeginMap;
-  emitter << YAML::Key << ROI_X_OFFSET_YML_NAME << YAML::Value << cam_info.roi.x_offset;
-  emitter << YAML::Key << ROI_Y_OFFSET_YML_NAME << YAML::Value << cam_info.roi.y_offset;
-  emitter << YAML::Key << ROI_HEIGHT_YML_NAME << YAML::Value << cam_info.roi.height;
-  emitter << YAML::Key << ROI_WIDTH_YML_NAME << YAML::Value << cam_info.roi.width;
-  emitter << YAML::Key << ROI_DO_RECTIFY_YML_NAME << YAML::Value << cam_info.roi.do_rectify;
-  emitter << YAML::EndMap;
-
-  emitter << YAML::EndMap;
-
-  out << emitter.c_str();
-  return true;
+  text += ROI_YML_NAME;
+  text += ":\n";
+  appendKey(text, ROI_X_OFFSET_YML_NAME, cam_info.roi.x_offset, "  ");
+  appendKey(text, ROI_Y_OFFSET_YML_NAME, cam_info.roi.y_offset, "  ");
+  appendKey(text, ROI_HEIGHT_YML_NAME, cam_info.roi.height, "  ");
+  appendKey(text, ROI_WIDTH_YML_NAME, cam_info.roi.width, "  ");
+  text += "  ";
+  text += ROI_DO_RECTIFY_YML_NAME;
+  text += cam_info.roi.do_rectify ? ": true\n" : ": false\n";
+
+  out.write(text.data(), static_cast<std::streamsize>(text.size()));
+  return out.good();
 }
 
 bool writeCalibrationYml(
@@ -206,66 +274,78 @@ bool writeCalibrationYml(
   return writeCalibrationYml(out, camera_name, cam_info);
 }
 
-bool readCalibrationYml(
-  std::istream & in, std::string & camera_name,
+namespace impl
+{
+
+bool parseCalibrationYmlDom(
+  const std::string & buffer, std::string & camera_name,
   CameraInfo & cam_info)
 {
+  // Parse into copies so that a malformed calibration leaves the outputs untouched.
+  std::string name;
+  CameraInfo result = cam_info;
   try {
-    YAML::Node doc = YAML::Load(in);
+    YAML::Node doc = YAML::Load(buffer);
 
     if (doc[CAM_YML_NAME]) {
-      doc[CAM_YML_NAME] >> camera_name;
+      doc[CAM_YML_NAME] >> name;
     } else {
-      camera_name = "unknown";
+      name = "unknown";
     }
 
-    doc[WIDTH_YML_NAME] >> cam_info.width;
-    doc[HEIGHT_YML_NAME] >> cam_info.height;
+    doc[WIDTH_YML_NAME] >> result.width;
+    doc[HEIGHT_YML_NAME] >> result.height;
 
     // Read in fixed-size matrices
-    SimpleMatrix K_(3, 3, &cam_info.k[0]);
-    doc[K_YML_NAME] >> K_;
-    SimpleMatrix R_(3, 3, &cam_info.r[0]);
-    doc[R_YML_NAME] >> R_;
-    SimpleMatrix P_(3, 4, &cam_info.p[0]);
-    doc[P_YML_NAME] >> P_;
+    SimpleMatrix K_(3, 3, &result.k[0]);
+    SimpleMatrix R_(3, 3, &result.r[0]);
+    SimpleMatrix P_(3, 4, &result.p[0]);
+    if (!readMatrix(doc[K_YML_NAME], K_YML_NAME, K_) ||
+      !readMatrix(doc[R_YML_NAME], R_YML_NAME, R_) ||
+      !readMatrix(doc[P_YML_NAME], P_YML_NAME, P_))
+    {
+      return false;
+    }
 
     // Different distortion models may have different numbers of parameters
     if (doc[DMODEL_YML_NAME]) {
-      doc[DMODEL_YML_NAME] >> cam_info.distortion_model;
+      doc[DMODEL_YML_NAME] >> result.distortion_model;
     } else {
       // Assume plumb bob for backwards compatibility
-      cam_info.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
+      result.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
       RCLCPP_WARN(
         kYmlLogger,
         "Camera calibration file did not specify distortion model, assuming plumb bob");
     }
     const YAML::Node & D_node = doc[D_YML_NAME];
     int D_rows, D_cols;
-    D_node["rows"] >> D_rows;
-    D_node["cols"] >> D_cols;
+    if (!readMatrixShape(D_node, D_YML_NAME, D_rows, D_cols)) {
+      return false;
+    }
     const YAML::Node & D_data = D_node["data"];
-    cam_info.d.resize(D_rows * D_cols);
-    for (int i = 0; i < D_rows * D_cols; ++i) {
-      D_data[i] >> cam_info.d[i];
+    result.d.resize(static_cast<size_t>(D_rows) * static_cast<size_t>(D_cols));
+    for (size_t i = 0; i < result.d.size(); ++i) {
+      D_data[i] >> result.d[i];
     }
 
     if (doc[BINNING_X_YML_NAME]) {
-      doc[BINNING_X_YML_NAME] >> cam_info.binning_x;
+      doc[BINNING_X_YML_NAME] >> result.binning_x;
     }
     if (doc[BINNING_Y_YML_NAME]) {
-      doc[BINNING_Y_YML_NAME] >> cam_info.binning_y;
+      doc[BINNING_Y_YML_NAME] >> result.binning_y;
     }
 
     if (doc[ROI_YML_NAME]) {
       const YAML::Node & roi_node = doc[ROI_YML_NAME];
-      roi_node[ROI_X_OFFSET_YML_NAME] >> cam_info.roi.x_offset;
-      roi_node[ROI_Y_OFFSET_YML_NAME] >> cam_info.roi.y_offset;
-      roi_node[ROI_HEIGHT_YML_NAME] >> cam_info.roi.height;
-      roi_node[ROI_WIDTH_YML_NAME] >> cam_info.roi.width;
-      roi_node[ROI_DO_RECTIFY_YML_NAME] >> cam_info.roi.do_rectify;
+      roi_node[ROI_X_OFFSET_YML_NAME] >> result.roi.x_offset;
+      roi_node[ROI_Y_OFFSET_YML_NAME] >> result.roi.y_offset;
+      roi_node[ROI_HEIGHT_YML_NAME] >> result.roi.height;
+      roi_node[ROI_WIDTH_YML_NAME] >> result.roi.width;
+      roi_node[ROI_DO_RECTIFY_YML_NAME] >> result.roi.do_rectify;
     }
 
+    camera_name = std::move(name);
+    cam_info = std::move(result);
     return true;
   } catch (YAML::Exception & e) {
     RCLCPP_WARN(kYmlLogger, "Exception parsing YAML camera calibration:\n%s", e.what());
@@ -273,16 +353,26 @@ bool readCalibrationYml(
   }
 }
 
+}  // namespace impl
+
+bool readCalibrationYml(
+  std::istream & in, std::string & camera_name,
+  CameraInfo & cam_info)
+{
+  const std::string buffer{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  return parseCalibrationYml(buffer, camera_name, cam_info);
+}
+
 bool readCalibrationYml(
   const std::string & file_name, std::string & camera_name,
   CameraInfo & cam_info)
 {
-  std::ifstream fin(file_name.c_str());
-  if (!fin.good()) {
+  impl::MappedFile file(file_name);
+  if (!file.valid()) {
     RCLCPP_ERROR(kYmlLogger, "Unable to open camera calibration file [%s]", file_name.c_str());
     return false;
   }
-  bool success = readCalibrationYml(fin, camera_name, cam_info);
+  bool success = parseCalibrationYml(file.data(), camera_name, cam_info);
   if (!success) {
     RCLCPP_ERROR(
       kYmlLogger, "Failed to parse camera calibration from file [%s]",
@@ -295,8 +385,18 @@ bool parseCalibrationYml(
   const std::string & buffer, std::string & camera_name,
   CameraInfo & cam_info)
 {
-  std::stringstream ss(buffer);
-  return readCalibrationYml(ss, camera_name, cam_info);
+  // Calibrations in the layout written above are read in a single pass; anything the
+  // streaming parser does not understand goes through the full YAML parser.
+  return impl::parseCalibrationYmlStream(buffer, camera_name, cam_info) ||
+         impl::parseCalibrationYmlDom(buffer, camera_name, cam_info);
+}
+
+bool parseCalibrationYml(
+  std::string_view buffer, std::string & camera_name,
+  CameraInfo & cam_info)
+{
+  return impl::parseCalibrationYmlStream(buffer, camera_name, cam_info) ||
+         impl::parseCalibrationYmlDom(std::string(buffer), camera_name, cam_info);
 }
 
 }  // namespace camera_calibration_parsers
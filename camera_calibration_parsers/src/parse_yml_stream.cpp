@@ -0,0 +1,579 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "parse_yml_stream.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "rclcpp/logging.hpp"
+#include "sensor_msgs/distortion_models.hpp"
+
+namespace camera_calibration_parsers
+{
+namespace impl
+{
+
+/// \cond
+
+namespace
+{
+
+// One significant line: indentation, then the content with any trailing comment removed.
+struct Line
+{
+  std::size_t indent = 0;
+  std::string_view content;
+};
+
+// Forward-only reader over the significant lines of a buffer, with one line of lookahead.
+class LineReader
+{
+public:
+  explicit LineReader(std::string_view text)
+  : text_(text)
+  {}
+
+  bool peek(Line & line)
+  {
+    if (!has_pending_) {
+      has_pending_ = read(pending_);
+    }
+    line = pending_;
+    return has_pending_;
+  }
+
+  void next()
+  {
+    has_pending_ = false;
+  }
+
+  // Set when the reader saw something it cannot interpret as a line (tab indentation).
+  bool failed() const
+  {
+    return failed_;
+  }
+
+private:
+  bool read(Line & line)
+  {
+    while (!failed_ && pos_ < text_.size()) {
+      std::size_t end = text_.find('\n', pos_);
+      if (end == std::string_view::npos) {
+        end = text_.size();
+      }
+      std::string_view raw = text_.substr(pos_, end - pos_);
+      pos_ = end + 1;
+
+      std::size_t indent = raw.find_first_not_of(' ');
+      if (indent == std::string_view::npos) {
+        continue;
+      }
+      if (raw[indent] == '\t') {
+        failed_ = true;
+        return false;
+      }
+      std::string_view content = raw.substr(indent);
+      if (content[0] == '#') {
+        continue;
+      }
+      std::size_t comment = content.find(" #");
+      if (comment != std::string_view::npos) {
+        content = content.substr(0, comment);
+      }
+      std::size_t last = content.find_last_not_of(" \t\r");
+      if (last == std::string_view::npos) {
+        continue;
+      }
+      line.indent = indent;
+      line.content = content.substr(0, last + 1);
+      return true;
+    }
+    return false;
+  }
+
+  std::string_view text_;
+  std::size_t pos_ = 0;
+  Line pending_;
+  bool has_pending_ = false;
+  bool failed_ = false;
+};
+
+std::string_view trim(std::string_view s)
+{
+  std::size_t first = s.find_first_not_of(" \t");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return s.substr(first, s.find_last_not_of(" \t") - first + 1);
+}
+
+// Split "key: value" (or "key:"); only plain identifiers are accepted as keys.
+bool splitKey(std::string_view content, std::string_view & key, std::string_view & value)
+{
+  std::size_t colon = content.find(':');
+  if (colon == 0 || colon == std::string_view::npos) {
+    return false;
+  }
+  if (colon + 1 < content.size() && content[colon + 1] != ' ') {
+    return false;
+  }
+  key = content.substr(0, colon);
+  for (char c : key) {
+    bool ident = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+      (c >= '0' && c <= '9') || c == '_';
+    if (!ident) {
+      return false;
+    }
+  }
+  value = trim(content.substr(colon + 1));
+  return true;
+}
+
+// A scalar that YAML reads back verbatim as a string: no quoting, no indicators, not null.
+bool isPlainString(std::string_view v)
+{
+  if (v.empty() || v == "~" || v == "null" || v == "Null" || v == "NULL") {
+    return false;
+  }
+  if (std::string_view("-?:,[]{}#&*!|>%@`").find(v[0]) != std::string_view::npos) {
+    return false;
+  }
+  return v.find_first_of("\"'") == std::string_view::npos &&
+         v.find(": ") == std::string_view::npos && v.find(":\t") == std::string_view::npos &&
+         v.back() != ':';
+}
+
+template<typename T>
+bool parseInteger(std::string_view v, T & out)
+{
+  // yaml-cpp reads a leading zero as octal; leave those to the DOM parser.
+  std::string_view digits = !v.empty() && v[0] == '-' ? v.substr(1) : v;
+  if (digits.size() > 1 && digits[0] == '0') {
+    return false;
+  }
+  const char * end = v.data() + v.size();
+  auto result = std::from_chars(v.data(), end, out);
+  return result.ec == std::errc() && result.ptr == end;
+}
+
+bool parseDouble(std::string_view v, double & out)
+{
+  // from_chars also takes "inf", "nan" and hex floats, which yaml-cpp spells differently;
+  // leave anything beyond decimal notation to the DOM parser.
+  if (v.empty() || v.find_first_not_of("0123456789.eE+-") != std::string_view::npos ||
+    v[0] == '+')
+  {
+    return false;
+  }
+  const char * end = v.data() + v.size();
+  auto result = std::from_chars(v.data(), end, out);
+  return result.ec == std::errc() && result.ptr == end;
+}
+
+bool parseBool(std::string_view v, bool & out)
+{
+  static constexpr std::string_view kTrue[] = {"true", "True", "TRUE", "yes", "Yes", "YES",
+    "on", "On", "ON"};
+  static constexpr std::string_view kFalse[] = {"false", "False", "FALSE", "no", "No", "NO",
+    "off", "Off", "OFF"};
+  for (std::string_view t : kTrue) {
+    if (v == t) {
+      out = true;
+      return true;
+    }
+  }
+  for (std::string_view f : kFalse) {
+    if (v == f) {
+      out = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+// rows/cols/data block; data goes to a fixed buffer so that parsing does not allocate.
+struct Matrix
+{
+  static constexpr std::size_t kCapacity = 32;
+
+  int rows = 0;
+  int cols = 0;
+  std::array<double, kCapacity> data{};
+  std::size_t count = 0;
+  bool has_rows = false;
+  bool has_cols = false;
+  bool has_data = false;
+
+  bool append(std::string_view item)
+  {
+    return count < kCapacity && parseDouble(trim(item), data[count++]);
+  }
+
+  bool complete(int expected_rows, int expected_cols) const
+  {
+    if (!has_rows || !has_cols || !has_data) {
+      return false;
+    }
+    if (expected_rows >= 0 && (rows != expected_rows || cols != expected_cols)) {
+      return false;
+    }
+    return rows >= 0 && cols >= 0 &&
+           static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols) == count;
+  }
+};
+
+// "[a, b, c]", possibly continued over the following lines.
+bool parseFlowSequence(std::string_view first, LineReader & reader, Matrix & m)
+{
+  std::string_view rest = first.substr(1);
+  bool need_item = true;
+  for (;;) {
+    std::size_t close = rest.find(']');
+    std::string_view items = rest.substr(0, close);
+    for (;;) {
+      std::size_t comma = items.find(',');
+      std::string_view item = trim(items.substr(0, comma));
+      if (!item.empty()) {
+        if (!need_item || !m.append(item)) {
+          return false;
+        }
+        need_item = false;
+      }
+      if (comma == std::string_view::npos) {
+        break;
+      }
+      if (need_item) {
+        return false;
+      }
+      need_item = true;
+      items = items.substr(comma + 1);
+    }
+    if (close != std::string_view::npos) {
+      return trim(rest.substr(close + 1)).empty();
+    }
+    Line line;
+    if (!reader.peek(line) || line.indent == 0) {
+      return false;
+    }
+    reader.next();
+    rest = line.content;
+  }
+}
+
+// "- a" items, one per line, at or below min_indent.
+bool parseBlockSequence(LineReader & reader, std::size_t min_indent, Matrix & m)
+{
+  Line line;
+  bool any = false;
+  std::size_t indent = min_indent;
+  while (reader.peek(line) && line.indent >= min_indent) {
+    // Every item must line up with the first; anything else ends the sequence.
+    if ((any && line.indent != indent) ||
+      line.content[0] != '-' || (line.content.size() > 1 && line.content[1] != ' '))
+    {
+      break;
+    }
+    indent = line.indent;
+    if (!m.append(line.content.substr(1))) {
+      return false;
+    }
+    any = true;
+    reader.next();
+  }
+  return any;
+}
+
+// Determine the indentation of a nested block; it must be deeper than its key.
+bool blockIndent(LineReader & reader, std::size_t & indent)
+{
+  Line line;
+  if (!reader.peek(line) || line.indent == 0) {
+    return false;
+  }
+  indent = line.indent;
+  return true;
+}
+
+bool parseMatrix(LineReader & reader, Matrix & m)
+{
+  std::size_t indent;
+  if (!blockIndent(reader, indent)) {
+    return false;
+  }
+  Line line;
+  while (reader.peek(line) && line.indent > 0) {
+    std::string_view key, value;
+    if (line.indent != indent || !splitKey(line.content, key, value)) {
+      return false;
+    }
+    reader.next();
+    if (key == "rows") {
+      if (m.has_rows || !parseInteger(value, m.rows)) {
+        return false;
+      }
+      m.has_rows = true;
+    } else if (key == "cols") {
+      if (m.has_cols || !parseInteger(value, m.cols)) {
+        return false;
+      }
+      m.has_cols = true;
+    } else if (key == "data") {
+      if (m.has_data) {
+        return false;
+      }
+      m.has_data = true;
+      if (value.empty()) {
+        if (!parseBlockSequence(reader, indent, m)) {
+          return false;
+        }
+      } else if (value[0] != '[' || !parseFlowSequence(value, reader, m)) {
+        return false;
+      }
+    } else if (value.empty() || !isPlainString(value)) {
+      // Extra scalars such as OpenCV's "dt: d" are ignored, like the DOM parser does.
+      return false;
+    }
+  }
+  return true;
+}
+
+// Skip the block under a key the parser does not use. Only a flat map of plain scalars is
+// skipped; anything else is left to the DOM parser, which knows whether it is valid YAML.
+bool skipBlock(LineReader & reader)
+{
+  std::size_t indent = 0;
+  Line line;
+  while (reader.peek(line) && line.indent > 0) {
+    std::string_view key, value;
+    if ((indent != 0 && line.indent != indent) || !splitKey(line.content, key, value) ||
+      (!value.empty() && !isPlainString(value)))
+    {
+      return false;
+    }
+    indent = line.indent;
+    reader.next();
+  }
+  return true;
+}
+
+struct Roi
+{
+  uint32_t x_offset = 0;
+  uint32_t y_offset = 0;
+  uint32_t height = 0;
+  uint32_t width = 0;
+  bool do_rectify = false;
+  unsigned seen = 0;
+};
+
+bool parseRoi(LineReader & reader, Roi & roi)
+{
+  std::size_t indent;
+  if (!blockIndent(reader, indent)) {
+    return false;
+  }
+  Line line;
+  while (reader.peek(line) && line.indent > 0) {
+    std::string_view key, value;
+    if (line.indent != indent || !splitKey(line.content, key, value)) {
+      return false;
+    }
+    reader.next();
+    unsigned bit;
+    bool ok;
+    if (key == "x_offset") {
+      bit = 1u;
+      ok = parseInteger(value, roi.x_offset);
+    } else if (key == "y_offset") {
+      bit = 2u;
+      ok = parseInteger(value, roi.y_offset);
+    } else if (key == "height") {
+      bit = 4u;
+      ok = parseInteger(value, roi.height);
+    } else if (key == "width") {
+      bit = 8u;
+      ok = parseInteger(value, roi.width);
+    } else if (key == "do_rectify") {
+      bit = 16u;
+      ok = parseBool(value, roi.do_rectify);
+    } else {
+      bit = 0u;
+      ok = !value.empty() && isPlainString(value);
+    }
+    if (!ok || (roi.seen & bit)) {
+      return false;
+    }
+    roi.seen |= bit;
+  }
+  return roi.seen == 31u;
+}
+
+enum Field : unsigned
+{
+  kCameraName = 1u << 0,
+  kWidth = 1u << 1,
+  kHeight = 1u << 2,
+  kK = 1u << 3,
+  kD = 1u << 4,
+  kR = 1u << 5,
+  kP = 1u << 6,
+  kDistortionModel = 1u << 7,
+  kBinningX = 1u << 8,
+  kBinningY = 1u << 9,
+  kRoi = 1u << 10,
+  kRequired = kWidth | kHeight | kK | kD | kR | kP,
+};
+
+}  // namespace
+
+/// \endcond
+
+bool parseCalibrationYmlStream(
+  std::string_view buffer, std::string & camera_name,
+  sensor_msgs::msg::CameraInfo & cam_info)
+{
+  std::string_view name, model;
+  uint32_t width = 0, height = 0, binning_x = 0, binning_y = 0;
+  Matrix K, D, R, P;
+  Roi roi;
+  unsigned seen = 0;
+
+  LineReader reader(buffer);
+  Line line;
+  while (reader.peek(line)) {
+    std::string_view key, value;
+    if (line.indent != 0 || !splitKey(line.content, key, value)) {
+      return false;
+    }
+    reader.next();
+
+    unsigned field = 0;
+    bool ok = true;
+    if (key == "camera_name") {
+      field = kCameraName;
+      ok = isPlainString(value);
+      name = value;
+    } else if (key == "image_width") {
+      field = kWidth;
+      ok = parseInteger(value, width);
+    } else if (key == "image_height") {
+      field = kHeight;
+      ok = parseInteger(value, height);
+    } else if (key == "distortion_model") {
+      field = kDistortionModel;
+      ok = isPlainString(value);
+      model = value;
+    } else if (key == "binning_x") {
+      field = kBinningX;
+      ok = parseInteger(value, binning_x);
+    } else if (key == "binning_y") {
+      field = kBinningY;
+      ok = parseInteger(value, binning_y);
+    } else if (key == "camera_matrix") {
+      field = kK;
+      ok = value.empty() && parseMatrix(reader, K);
+    } else if (key == "distortion_coefficients") {
+      field = kD;
+      ok = value.empty() && parseMatrix(reader, D);
+    } else if (key == "rectification_matrix") {
+      field = kR;
+      ok = value.empty() && parseMatrix(reader, R);
+    } else if (key == "projection_matrix") {
+      field = kP;
+      ok = value.empty() && parseMatrix(reader, P);
+    } else if (key == "roi") {
+      field = kRoi;
+      ok = value.empty() && parseRoi(reader, roi);
+    } else if (value.empty()) {
+      ok = skipBlock(reader);
+    } else {
+      ok = isPlainString(value);
+    }
+    if (!ok || (seen & field)) {
+      return false;
+    }
+    seen |= field;
+  }
+
+  if (reader.failed() || (seen & kRequired) != kRequired ||
+    !K.complete(3, 3) || !R.complete(3, 3) || !P.complete(3, 4) || !D.complete(-1, -1))
+  {
+    return false;
+  }
+
+  // Everything checked out; only now touch the outputs.
+  camera_name = (seen & kCameraName) ? std::string(name) : std::string("unknown");
+  cam_info.width = width;
+  cam_info.height = height;
+  for (std::size_t i = 0; i < 9; ++i) {
+    cam_info.k[i] = K.data[i];
+    cam_info.r[i] = R.data[i];
+  }
+  for (std::size_t i = 0; i < 12; ++i) {
+    cam_info.p[i] = P.data[i];
+  }
+  if (seen & kDistortionModel) {
+    cam_info.distortion_model.assign(model.data(), model.size());
+  } else {
+    // Assume plumb bob for backwards compatibility
+    cam_info.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
+    RCLCPP_WARN(
+      rclcpp::get_logger("camera_calibration_parsers"),
+      "Camera calibration file did not specify distortion model, assuming plumb bob");
+  }
+  cam_info.d.assign(D.data.begin(), D.data.begin() + D.count);
+  if (seen & kBinningX) {
+    cam_info.binning_x = binning_x;
+  }
+  if (seen & kBinningY) {
+    cam_info.binning_y = binning_y;
+  }
+  if (seen & kRoi) {
+    cam_info.roi.x_offset = roi.x_offset;
+    cam_info.roi.y_offset = roi.y_offset;
+    cam_info.roi.height = roi.height;
+    cam_info.roi.width = roi.width;
+    cam_info.roi.do_rectify = roi.do_rectify;
+  }
+  return true;
+}
+
+}  // namespace impl
+}  // namespace camera_calibration_parsers
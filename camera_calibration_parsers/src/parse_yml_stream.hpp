@@ -0,0 +1,71 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef PARSE_YML_STREAM_HPP_
+#define PARSE_YML_STREAM_HPP_
+
+#include <string>
+#include <string_view>
+
+#include "sensor_msgs/msg/camera_info.hpp"
+
+namespace camera_calibration_parsers
+{
+namespace impl
+{
+
+/**
+ * \brief Parse a YAML calibration in one forward pass, without building a YAML DOM.
+ *
+ * Handles the camera calibration schema as written by writeCalibrationYml() and the
+ * camera_calibration tools: plain scalars, comments, nested mappings, and flow or block
+ * sequences. Anything else, including invalid calibrations, makes it return false without
+ * touching the outputs, so the caller can hand the input to parseCalibrationYmlDom() for the
+ * full YAML treatment and its error reporting.
+ */
+bool parseCalibrationYmlStream(
+  std::string_view buffer, std::string & camera_name,
+  sensor_msgs::msg::CameraInfo & cam_info);
+
+/**
+ * \brief Parse a YAML calibration through a yaml-cpp DOM.
+ */
+bool parseCalibrationYmlDom(
+  const std::string & buffer, std::string & camera_name,
+  sensor_msgs::msg::CameraInfo & cam_info);
+
+}  // namespace impl
+}  // namespace camera_calibration_parsers
+
+#endif  // PARSE_YML_STREAM_HPP_
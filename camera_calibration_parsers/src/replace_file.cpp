@@ -0,0 +1,109 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "replace_file.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace camera_calibration_parsers
+{
+namespace impl
+{
+
+bool replaceFile(const std::string & file_name, std::string_view contents, std::string & error)
+{
+  std::string temp_name = file_name + ".XXXXXX";
+#ifndef _WIN32
+  int fd = mkstemp(&temp_name[0]);
+  if (fd < 0) {
+    error = std::string("cannot create a temporary file: ") + strerror(errno);
+    return false;
+  }
+  // mkstemp() makes the file private, keep the permissions of the file it replaces instead.
+  struct stat st;
+  fchmod(fd, ::stat(file_name.c_str(), &st) == 0 ? (st.st_mode & 0777) : 0644);
+  size_t written = 0;
+  while (written < contents.size()) {
+    ssize_t n = ::write(fd, contents.data() + written, contents.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      error = std::string("cannot write ") + temp_name + ": " + strerror(errno);
+      break;
+    }
+    written += static_cast<size_t>(n);
+  }
+  if (::close(fd) != 0 && error.empty()) {
+    error = std::string("cannot write ") + temp_name + ": " + strerror(errno);
+  }
+  bool ok = written == contents.size() && error.empty();
+#else
+  bool ok = _mktemp_s(&temp_name[0], temp_name.size() + 1) == 0;
+  if (ok) {
+    std::ofstream out(temp_name, std::ios::binary);
+    out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    ok = out.good();
+  }
+  if (!ok) {
+    error = "cannot write " + temp_name;
+  }
+#endif
+  std::error_code ec;
+  if (!ok) {
+    std::filesystem::remove(temp_name, ec);
+    return false;
+  }
+  std::filesystem::rename(temp_name, file_name, ec);
+  if (ec) {
+    error = ec.message();
+    std::filesystem::remove(temp_name, ec);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace impl
+}  // namespace camera_calibration_parsers
@@ -0,0 +1,264 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures parsing and loading over a generated corpus of calibration files.
+//
+// The corpus covers every distortion model in every format that can store it, plus a model
+// with a large D vector, with kFilesPerModel distinct files of each. It is written to a
+// temporary directory on first use and removed at exit.
+//
+// BM_Parse arguments: format (0: yml, 1: ini, 2: ccal), model (see kModels).
+// BM_ReadCalibration argument: format.
+// BM_ReadCalibrations argument: maximum number of threads (0: hardware concurrency).
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "camera_calibration_parsers/parse.hpp"
+#include "sensor_msgs/distortion_models.hpp"
+#include "sensor_msgs/msg/camera_info.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+struct Model
+{
+  const char * name;
+  const char * distortion_model;
+  std::size_t d_size;
+};
+
+const Model kModels[] = {
+  {"plumb_bob", sensor_msgs::distortion_models::PLUMB_BOB, 5},
+  {"rational_polynomial", sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL, 8},
+  {"equidistant", sensor_msgs::distortion_models::EQUIDISTANT, 4},
+  {"large_d", "polynomial_28", 28},
+};
+const std::size_t kNumModels = sizeof(kModels) / sizeof(kModels[0]);
+
+const char * const kFormats[] = {"yml", "ini", "ccal"};
+const std::size_t kNumFormats = sizeof(kFormats) / sizeof(kFormats[0]);
+
+const std::size_t kFilesPerModel = 250;
+
+// The INI format only stores plumb bob calibrations.
+bool supported(std::size_t format, std::size_t model)
+{
+  return format != 1 || model == 0;
+}
+
+sensor_msgs::msg::CameraInfo makeCalibration(const Model & model, std::size_t seed)
+{
+  // Vary every value with the seed so that no two files in the corpus are the same.
+  const double jitter = 1.0 + 1e-4 * static_cast<double>(seed);
+  sensor_msgs::msg::CameraInfo cam_info;
+  cam_info.width = 1920;
+  cam_info.height = 1080;
+  cam_info.distortion_model = model.distortion_model;
+  cam_info.d.resize(model.d_size);
+  for (std::size_t i = 0; i < cam_info.d.size(); ++i) {
+    cam_info.d[i] = -0.0123456789 * static_cast<double>(i + 1) * jitter;
+  }
+  cam_info.k = {1402.5317 * jitter, 0, 962.70413, 0, 1401.9283 * jitter, 538.21577, 0, 0, 1};
+  cam_info.r = {0.99998, 0.00213, -0.00512, -0.00214, 0.99999, -0.00098, 0.00512, 0.00099, 0.99998};
+  cam_info.p = {
+    1398.2243 * jitter, 0, 960.14102, -84.305122, 0, 1398.2243 * jitter, 541.33215, 0, 0, 0, 1, 0};
+  cam_info.roi.width = 1920;
+  cam_info.roi.height = 1080;
+  return cam_info;
+}
+
+class Corpus
+{
+public:
+  static const Corpus & get()
+  {
+    static const Corpus corpus;
+    return corpus;
+  }
+
+  Corpus(const Corpus &) = delete;
+  Corpus & operator=(const Corpus &) = delete;
+
+  ~Corpus()
+  {
+    std::error_code ec;
+    fs::remove_all(dir_, ec);
+  }
+
+  // The first file of a format and model, read into memory.
+  const std::string & sample(std::size_t format, std::size_t model) const
+  {
+    return samples_[format][model];
+  }
+
+  const std::vector<std::string> & files(std::size_t format) const
+  {
+    return files_[format];
+  }
+
+  const std::vector<std::string> & allFiles() const
+  {
+    return all_files_;
+  }
+
+  bool ok() const
+  {
+    return ok_;
+  }
+
+private:
+  Corpus()
+  : dir_(fs::temp_directory_path() /
+      ("ccp_benchmark_corpus_" + std::to_string(std::random_device()())))
+  {
+    fs::create_directories(dir_);
+    for (std::size_t format = 0; format < kNumFormats; ++format) {
+      for (std::size_t model = 0; model < kNumModels; ++model) {
+        if (!supported(format, model)) {
+          continue;
+        }
+        for (std::size_t i = 0; i < kFilesPerModel; ++i) {
+          const fs::path file = dir_ / (std::string(kModels[model].name) + "_" +
+            std::to_string(i) + "." + kFormats[format]);
+          ok_ &= camera_calibration_parsers::writeCalibration(
+            file.string(), "camera_" + std::to_string(i), makeCalibration(kModels[model], i));
+          files_[format].push_back(file.string());
+          all_files_.push_back(file.string());
+          if (i == 0) {
+            std::ifstream in(file, std::ios::binary);
+            samples_[format][model].assign(
+              std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+          }
+        }
+      }
+    }
+  }
+
+  fs::path dir_;
+  bool ok_ = true;
+  std::string samples_[kNumFormats][kNumModels];
+  std::vector<std::string> files_[kNumFormats];
+  std::vector<std::string> all_files_;
+};
+
+}  // namespace
+
+static void BM_Parse(benchmark::State & state)
+{
+  const std::size_t format = static_cast<std::size_t>(state.range(0));
+  const std::size_t model = static_cast<std::size_t>(state.range(1));
+  const Corpus & corpus = Corpus::get();
+  const std::string & buffer = corpus.sample(format, model);
+  state.SetLabel(std::string(kFormats[format]) + "/" + kModels[model].name);
+  if (!corpus.ok()) {
+    state.SkipWithError("could not write the corpus");
+    return;
+  }
+
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info;
+  for (auto _ : state) {
+    if (!camera_calibration_parsers::parseCalibration(
+        std::string_view(buffer), camera_name, cam_info))
+    {
+      state.SkipWithError("calibration did not parse");
+      break;
+    }
+    benchmark::DoNotOptimize(cam_info);
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(buffer.size()));
+}
+
+static void parseArguments(benchmark::internal::Benchmark * b)
+{
+  for (std::size_t format = 0; format < kNumFormats; ++format) {
+    for (std::size_t model = 0; model < kNumModels; ++model) {
+      if (supported(format, model)) {
+        b->Args({static_cast<int64_t>(format), static_cast<int64_t>(model)});
+      }
+    }
+  }
+}
+BENCHMARK(BM_Parse)->Apply(parseArguments);
+
+static void BM_ReadCalibration(benchmark::State & state)
+{
+  const std::size_t format = static_cast<std::size_t>(state.range(0));
+  const Corpus & corpus = Corpus::get();
+  const std::vector<std::string> & files = corpus.files(format);
+  state.SetLabel(kFormats[format]);
+  if (!corpus.ok()) {
+    state.SkipWithError("could not write the corpus");
+    return;
+  }
+
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info;
+  bool ok = true;
+  for (auto _ : state) {
+    for (const std::string & file : files) {
+      ok &= camera_calibration_parsers::readCalibration(file, camera_name, cam_info);
+      benchmark::DoNotOptimize(cam_info);
+    }
+    if (!ok) {
+      state.SkipWithError("calibration did not load");
+      break;
+    }
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(files.size()));
+}
+BENCHMARK(BM_ReadCalibration)->DenseRange(0, kNumFormats - 1);
+
+static void BM_ReadCalibrations(benchmark::State & state)
+{
+  const Corpus & corpus = Corpus::get();
+  const std::vector<std::string> & files = corpus.allFiles();
+  if (!corpus.ok()) {
+    state.SkipWithError("could not write the corpus");
+    return;
+  }
+
+  for (auto _ : state) {
+    auto results = camera_calibration_parsers::readCalibrations(
+      files, static_cast<std::size_t>(state.range(0)));
+    benchmark::DoNotOptimize(results);
+    bool ok = true;
+    for (const auto & result : results) {
+      ok &= result.success;
+    }
+    if (!ok) {
+      state.SkipWithError("calibration did not load");
+      break;
+    }
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(files.size()));
+}
+BENCHMARK(BM_ReadCalibrations)->Arg(1)->Arg(4)->Arg(0)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,158 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the streaming YAML calibration parser with the yaml-cpp DOM parser, and measures
+// writeCalibrationYml.
+//
+// The benchmark argument selects the distortion model (0: plumb_bob, 1: rational_polynomial).
+// The "allocs" counter is the number of heap allocations per parse.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "camera_calibration_parsers/parse_yml.hpp"
+#include "sensor_msgs/distortion_models.hpp"
+#include "sensor_msgs/msg/camera_info.hpp"
+
+#include "parse_yml_stream.hpp"
+
+// Once the replacement operators below are inlined GCC pairs std::free with operator new.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<std::size_t> g_allocations{0};
+
+void * operator new(std::size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void * p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+static std::string makeCalibration(int model)
+{
+  sensor_msgs::msg::CameraInfo cam_info;
+  cam_info.width = 1920;
+  cam_info.height = 1080;
+  cam_info.distortion_model = model == 0 ?
+    sensor_msgs::distortion_models::PLUMB_BOB :
+    sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL;
+  cam_info.d.resize(model == 0 ? 5 : 8);
+  for (std::size_t i = 0; i < cam_info.d.size(); ++i) {
+    cam_info.d[i] = -0.0123456789 * static_cast<double>(i + 1);
+  }
+  cam_info.k = {1402.5317, 0, 962.70413, 0, 1401.9283, 538.21577, 0, 0, 1};
+  cam_info.r = {0.99998, 0.00213, -0.00512, -0.00214, 0.99999, -0.00098, 0.00512, 0.00099, 0.99998};
+  cam_info.p = {1398.2243, 0, 960.14102, -84.305122, 0, 1398.2243, 541.33215, 0, 0, 0, 1, 0};
+  cam_info.roi.width = 1920;
+  cam_info.roi.height = 1080;
+
+  std::ostringstream out;
+  camera_calibration_parsers::writeCalibrationYml(out, "front_left_camera", cam_info);
+  return out.str();
+}
+
+template<typename Parse>
+static void runParse(benchmark::State & state, Parse parse)
+{
+  const std::string calibration = makeCalibration(static_cast<int>(state.range(0)));
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info;
+  std::size_t allocations = 0;
+
+  for (auto _ : state) {
+    std::size_t before = g_allocations.load(std::memory_order_relaxed);
+    bool ok = parse(calibration, camera_name, cam_info);
+    allocations += g_allocations.load(std::memory_order_relaxed) - before;
+    if (!ok) {
+      state.SkipWithError("calibration did not parse");
+      break;
+    }
+    benchmark::DoNotOptimize(cam_info);
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(calibration.size()));
+  state.counters["allocs"] = benchmark::Counter(
+    static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+static void BM_ParseYmlStream(benchmark::State & state)
+{
+  runParse(
+    state, [](const std::string & buffer, std::string & name, sensor_msgs::msg::CameraInfo & info)
+    {return camera_calibration_parsers::impl::parseCalibrationYmlStream(buffer, name, info);});
+}
+BENCHMARK(BM_ParseYmlStream)->Arg(0)->Arg(1);
+
+static void BM_ParseYmlDom(benchmark::State & state)
+{
+  runParse(
+    state, [](const std::string & buffer, std::string & name, sensor_msgs::msg::CameraInfo & info)
+    {return camera_calibration_parsers::impl::parseCalibrationYmlDom(buffer, name, info);});
+}
+BENCHMARK(BM_ParseYmlDom)->Arg(0)->Arg(1);
+
+static void BM_ReadCalibrationYmlStream(benchmark::State & state)
+{
+  runParse(
+    state, [](const std::string & buffer, std::string & name, sensor_msgs::msg::CameraInfo & info)
+    {
+      std::istringstream in(buffer);
+      return camera_calibration_parsers::readCalibrationYml(in, name, info);
+    });
+}
+BENCHMARK(BM_ReadCalibrationYmlStream)->Arg(0)->Arg(1);
+
+static void BM_WriteCalibrationYml(benchmark::State & state)
+{
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info;
+  camera_calibration_parsers::parseCalibrationYml(
+    makeCalibration(static_cast<int>(state.range(0))), camera_name, cam_info);
+  std::size_t allocations = 0;
+  int64_t bytes = 0;
+
+  for (auto _ : state) {
+    std::size_t before = g_allocations.load(std::memory_order_relaxed);
+    std::ostringstream out;
+    camera_calibration_parsers::writeCalibrationYml(out, camera_name, cam_info);
+    allocations += g_allocations.load(std::memory_order_relaxed) - before;
+    bytes += static_cast<int64_t>(out.tellp());
+  }
+  state.SetBytesProcessed(bytes);
+  state.counters["allocs"] = benchmark::Counter(
+    static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_WriteCalibrationYml)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
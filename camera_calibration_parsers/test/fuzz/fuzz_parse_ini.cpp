@@ -0,0 +1,78 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// libFuzzer target for the INI calibration parser.
+//
+// Besides looking for crashes, checks that whatever the parser accepts survives a round trip:
+// whenever the result can be written (the INI writer only supports plumb bob), parsing it again
+// must reproduce the same file.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "camera_calibration_parsers/parse_ini.hpp"
+#include "rclcpp/logging.hpp"
+#include "sensor_msgs/msg/camera_info.hpp"
+
+static bool serialize(
+  const std::string & camera_name, const sensor_msgs::msg::CameraInfo & cam_info,
+  std::string & written)
+{
+  std::ostringstream out;
+  if (!camera_calibration_parsers::writeCalibrationIni(out, camera_name, cam_info)) {
+    return false;
+  }
+  written = out.str();
+  return true;
+}
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***)
+{
+  // Nearly every input is malformed; reporting each one would dominate the run.
+  rclcpp::get_logger("camera_calibration_parsers").set_level(rclcpp::Logger::Level::Fatal);
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size)
+{
+  const std::string_view buffer(reinterpret_cast<const char *>(data), size);
+
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info;
+  if (!camera_calibration_parsers::parseCalibrationIni(buffer, camera_name, cam_info)) {
+    return 0;
+  }
+
+  std::string written;
+  if (!serialize(camera_name, cam_info, written)) {
+    return 0;
+  }
+  std::string reread_name;
+  sensor_msgs::msg::CameraInfo reread_info;
+  if (!camera_calibration_parsers::parseCalibrationIni(written, reread_name, reread_info)) {
+    std::fprintf(stderr, "INI parser rejects its own output:\n%s\n", written.c_str());
+    std::abort();
+  }
+  std::string rewritten;
+  if (!serialize(reread_name, reread_info, rewritten) || rewritten != written) {
+    std::fprintf(stderr, "INI calibration changed on a round trip:\n%s\n", written.c_str());
+    std::abort();
+  }
+  return 0;
+}
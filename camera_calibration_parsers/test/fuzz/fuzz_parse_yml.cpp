@@ -0,0 +1,72 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// libFuzzer target for the YAML calibration parsers.
+//
+// Besides looking for crashes, checks the streaming parser against the yaml-cpp DOM parser:
+// any input the streaming parser accepts must be accepted by the DOM parser with the same
+// result. Results are compared through writeCalibrationYml() so that NaN coefficients compare
+// equal.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "camera_calibration_parsers/parse_yml.hpp"
+#include "rclcpp/logging.hpp"
+#include "sensor_msgs/msg/camera_info.hpp"
+
+#include "parse_yml_stream.hpp"
+
+static std::string serialize(
+  const std::string & camera_name, const sensor_msgs::msg::CameraInfo & cam_info)
+{
+  std::ostringstream out;
+  camera_calibration_parsers::writeCalibrationYml(out, camera_name, cam_info);
+  return out.str();
+}
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***)
+{
+  // Nearly every input is malformed; reporting each one would dominate the run.
+  rclcpp::get_logger("camera_calibration_parsers").set_level(rclcpp::Logger::Level::Fatal);
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size)
+{
+  const std::string buffer(reinterpret_cast<const char *>(data), size);
+
+  std::string stream_name, dom_name;
+  sensor_msgs::msg::CameraInfo stream_info, dom_info;
+  const bool stream_ok = camera_calibration_parsers::impl::parseCalibrationYmlStream(
+    buffer, stream_name, stream_info);
+  const bool dom_ok = camera_calibration_parsers::impl::parseCalibrationYmlDom(
+    buffer, dom_name, dom_info);
+
+  if (stream_ok) {
+    if (!dom_ok) {
+      std::fprintf(stderr, "Streaming YAML parser accepted input the DOM parser rejects\n");
+      std::abort();
+    }
+    if (serialize(stream_name, stream_info) != serialize(dom_name, dom_info)) {
+      std::fprintf(stderr, "Streaming and DOM YAML parsers disagree\n");
+      std::abort();
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,72 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs a libFuzzer target over saved inputs without linking libFuzzer, so the seed corpus and
+// any reproducers found by a fuzzing run can be checked by a regular build.
+//
+// Usage: fuzz_replay PATH...
+// Each PATH is an input file or a directory of input files.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerInitialize(int * argc, char *** argv);
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size);
+
+namespace fs = std::filesystem;
+
+int main(int argc, char ** argv)
+{
+  LLVMFuzzerInitialize(&argc, &argv);
+
+  std::vector<fs::path> inputs;
+  for (int i = 1; i < argc; ++i) {
+    const fs::path path(argv[i]);
+    if (fs::is_directory(path)) {
+      std::vector<fs::path> files;
+      for (const fs::directory_entry & entry : fs::directory_iterator(path)) {
+        if (entry.is_regular_file()) {
+          files.push_back(entry.path());
+        }
+      }
+      std::sort(files.begin(), files.end());
+      inputs.insert(inputs.end(), files.begin(), files.end());
+    } else {
+      inputs.push_back(path);
+    }
+  }
+  if (inputs.empty()) {
+    std::fprintf(stderr, "Usage: %s PATH...\nNo inputs to replay\n", argv[0]);
+    return 1;
+  }
+
+  for (const fs::path & input : inputs) {
+    std::ifstream file(input, std::ios::binary);
+    if (!file) {
+      std::fprintf(stderr, "Unable to open [%s]\n", input.string().c_str());
+      return 1;
+    }
+    const std::vector<uint8_t> data(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+  }
+  std::printf("Replayed %zu inputs\n", inputs.size());
+  return 0;
+}
@@ -0,0 +1,131 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
+#include "camera_calibration_parsers/parse.hpp"
+#include "sensor_msgs/distortion_models.hpp"
+#include "sensor_msgs/msg/camera_info.hpp"
+
+#include "make_calibs.hpp"
+
+namespace fs = std::filesystem;
+
+// Runs the convert tool in batch mode, built as CONVERT_EXECUTABLE.
+class Convert : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = fs::temp_directory_path() /
+      ("ccp_convert_test_" + std::to_string(std::random_device()()));
+    fs::create_directories(dir_ / "in");
+  }
+
+  void TearDown() override
+  {
+    std::error_code ec;
+    fs::remove_all(dir_, ec);
+  }
+
+  // Exit status of the tool for \a args.
+  int run(const std::string & args)
+  {
+    const std::string command = std::string("\"") + CONVERT_EXECUTABLE + "\" " + args;
+    int status = std::system(command.c_str());
+#ifndef _WIN32
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#else
+    return status;
+#endif
+  }
+
+  std::string path(const std::string & name) const
+  {
+    return (dir_ / name).string();
+  }
+
+  void write(const std::string & name, const std::string & camera_name)
+  {
+    ASSERT_TRUE(
+      camera_calibration_parsers::writeCalibration(
+        path(name), camera_name, make_calib(sensor_msgs::distortion_models::PLUMB_BOB)));
+  }
+
+  std::string readName(const std::string & name)
+  {
+    std::string camera_name;
+    sensor_msgs::msg::CameraInfo cam_info;
+    if (!camera_calibration_parsers::readCalibration(path(name), camera_name, cam_info)) {
+      return std::string();
+    }
+    check_calib(cam_info);
+    return camera_name;
+  }
+
+  fs::path dir_;
+};
+
+TEST_F(Convert, directory_to_output_dir) {
+  write("in/left.yml", "left");
+  write("in/right.ini", "right");
+
+  EXPECT_EQ(run("--to ccal -o \"" + path("out") + "\" \"" + path("in") + "\""), 0);
+  EXPECT_EQ(readName("out/left.ccal"), "left");
+  EXPECT_EQ(readName("out/right.ccal"), "right");
+
+  // Without -o the outputs go next to the inputs.
+  EXPECT_EQ(run("-j 1 --to yaml \"" + path("in/right.ini") + "\""), 0);
+  EXPECT_EQ(readName("in/right.yaml"), "right");
+}
+
+TEST_F(Convert, colliding_outputs) {
+  fs::create_directories(dir_ / "other");
+  write("in/camera.yml", "first");
+  write("other/camera.ini", "second");
+  write("in/unique.yml", "unique");
+
+  // Both inputs named camera would become out/camera.ccal: neither is converted.
+  EXPECT_NE(
+    run(
+      "--to ccal -o \"" + path("out") + "\" \"" + path("in") + "\" \"" +
+      path("other/camera.ini") + "\""), 0);
+  EXPECT_FALSE(fs::exists(dir_ / "out" / "camera.ccal"));
+  EXPECT_EQ(readName("out/unique.ccal"), "unique");
+}
+
+TEST_F(Convert, check) {
+  write("in/good.yml", "good");
+  EXPECT_EQ(run("--check \"" + path("in") + "\""), 0);
+
+  std::ofstream(path("in/bad.yml")) << "not: [a calibration\n";
+  EXPECT_NE(run("--check \"" + path("in") + "\""), 0);
+  // Checking writes nothing.
+  EXPECT_EQ(std::distance(fs::directory_iterator(dir_ / "in"), fs::directory_iterator()), 2);
+}
+
+TEST_F(Convert, no_inputs) {
+  EXPECT_NE(run("--check \"" + path("in") + "\""), 0);
+  EXPECT_NE(run("--to yml \"" + path("missing.ini") + "\""), 0);
+}
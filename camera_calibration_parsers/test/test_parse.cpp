@@ -0,0 +1,153 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "camera_calibration_parsers/parse.hpp"
+#include "camera_calibration_parsers/parse_ini.hpp"
+#include "camera_calibration_parsers/parse_yml.hpp"
+#include "sensor_msgs/distortion_models.hpp"
+#include "sensor_msgs/msg/camera_info.hpp"
+
+#include "make_calibs.hpp"
+
+using camera_calibration_parsers::detectCalibrationFormat;
+
+std::string custom_tmpnam()
+{
+#ifdef _WIN32
+  char name[L_tmpnam_s];
+  errno_t err = tmpnam_s(name, L_tmpnam_s);
+  if (err) {
+    printf("Error occured creating unique filename.\n");
+  }
+  return std::string(name);
+#else
+  char temp[] = "/tmp/calibs.XXXXXX";
+  int fd = mkstemp(temp);
+  close(fd);
+  return std::string(temp);
+#endif
+}
+
+TEST(Parse, detect_format) {
+  EXPECT_EQ(detectCalibrationFormat("image_width: 640\n"), "yml");
+  EXPECT_EQ(detectCalibrationFormat("\n# comment\n  \ncamera_matrix:\n  rows: 3\n"), "yml");
+  EXPECT_EQ(detectCalibrationFormat("%YAML 1.2\n---\nimage_width: 640\n"), "yml");
+  EXPECT_EQ(detectCalibrationFormat("---\n"), "yml");
+  EXPECT_EQ(detectCalibrationFormat("\xEF\xBB\xBFimage_width: 640\r\n"), "yml");
+
+  EXPECT_EQ(detectCalibrationFormat("# Camera intrinsics\n\n[image]\n\nwidth\n640\n"), "ini");
+  EXPECT_EQ(detectCalibrationFormat("; comment\nwidth\n"), "ini");
+  EXPECT_EQ(detectCalibrationFormat("  [mono_left]  \r\n"), "ini");
+
+  EXPECT_EQ(detectCalibrationFormat(""), "");
+  EXPECT_EQ(detectCalibrationFormat("# only a comment\n"), "");
+  EXPECT_EQ(detectCalibrationFormat("width\n640\n"), "");
+  EXPECT_EQ(detectCalibrationFormat("http://example.com\n"), "");
+}
+
+TEST(Parse, parse_detected_formats) {
+  auto cam_info = make_calib(sensor_msgs::distortion_models::PLUMB_BOB);
+
+  std::stringstream yml, ini;
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationYml(yml, "yml_camera", cam_info));
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationIni(ini, "ini_camera", cam_info));
+
+  for (auto [text, name] : {std::make_pair(yml.str(), "yml_camera"),
+      std::make_pair(ini.str(), "ini_camera")})
+  {
+    std::string camera_name;
+    sensor_msgs::msg::CameraInfo parsed;
+    ASSERT_TRUE(
+      camera_calibration_parsers::parseCalibration(std::string_view(text), camera_name, parsed));
+    EXPECT_EQ(camera_name, name);
+    check_calib(parsed);
+
+    // An empty format string also detects the format.
+    camera_name.clear();
+    ASSERT_TRUE(camera_calibration_parsers::parseCalibration(text, "", camera_name, parsed));
+    EXPECT_EQ(camera_name, name);
+
+    // A UTF-8 byte order mark is skipped.
+    camera_name.clear();
+    const std::string with_bom = "\xEF\xBB\xBF" + text;
+    ASSERT_TRUE(
+      camera_calibration_parsers::parseCalibration(
+        std::string_view(with_bom), camera_name, parsed));
+    EXPECT_EQ(camera_name, name);
+  }
+
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo parsed;
+  EXPECT_FALSE(
+    camera_calibration_parsers::parseCalibration(
+      std::string_view("not a calibration"), camera_name, parsed));
+}
+
+TEST(Parse, parse_explicit_format) {
+  auto cam_info = make_calib(sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL);
+  std::stringstream yml;
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationYml(yml, "yml_camera", cam_info));
+
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo parsed;
+  ASSERT_TRUE(camera_calibration_parsers::parseCalibration(yml.str(), "yml", camera_name, parsed));
+  EXPECT_EQ(camera_name, "yml_camera");
+  check_calib(parsed);
+  EXPECT_FALSE(camera_calibration_parsers::parseCalibration(yml.str(), "ini", camera_name, parsed));
+  EXPECT_FALSE(camera_calibration_parsers::parseCalibration(yml.str(), "xml", camera_name, parsed));
+}
+
+TEST(Parse, read_calibrations) {
+  auto plumb_bob = make_calib(sensor_msgs::distortion_models::PLUMB_BOB);
+  auto rational = make_calib(sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL);
+
+  std::vector<std::string> files;
+  for (int i = 0; i < 24; ++i) {
+    std::string temp = custom_tmpnam();
+    std::remove(temp.c_str());
+    static const char * kExtensions[] = {".yml", ".ini", ".ccal"};
+    std::string file = temp + kExtensions[i % 3];
+    const auto & cam_info = i % 3 == 1 ? plumb_bob : (i % 2 ? rational : plumb_bob);
+    ASSERT_TRUE(
+      camera_calibration_parsers::writeCalibration(file, "camera" + std::to_string(i), cam_info));
+    files.push_back(file);
+  }
+  files.insert(files.begin() + 5, "/nonexistent/calibration.yml");
+
+  auto results = camera_calibration_parsers::readCalibrations(files, 4);
+  ASSERT_EQ(results.size(), files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    EXPECT_EQ(results[i].file_name, files[i]);
+    if (i == 5) {
+      EXPECT_FALSE(results[i].success);
+      continue;
+    }
+    size_t n = i < 5 ? i : i - 1;
+    ASSERT_TRUE(results[i].success) << files[i];
+    EXPECT_EQ(results[i].camera_name, "camera" + std::to_string(n));
+    check_calib(results[i].cam_info);
+    std::remove(files[i].c_str());
+  }
+
+  EXPECT_TRUE(camera_calibration_parsers::readCalibrations({}).empty());
+}
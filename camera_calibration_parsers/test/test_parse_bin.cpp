@@ -0,0 +1,152 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "camera_calibration_parsers/parse.hpp"
+#include "camera_calibration_parsers/parse_bin.hpp"
+#include "sensor_msgs/distortion_models.hpp"
+#include "sensor_msgs/msg/camera_info.hpp"
+
+#include "make_calibs.hpp"
+
+std::string custom_tmpnam()
+{
+#ifdef _WIN32
+  char name[L_tmpnam_s];
+  errno_t err = tmpnam_s(name, L_tmpnam_s);
+  if (err) {
+    printf("Error occured creating unique filename.\n");
+  }
+  return std::string(name);
+#else
+  char temp[] = "/tmp/calib.XXXXXX";
+  int fd = mkstemp(temp);
+  close(fd);
+  return std::string(temp);
+#endif
+}
+
+static std::string writeBin(
+  const std::string & camera_name, const sensor_msgs::msg::CameraInfo & ci)
+{
+  std::ostringstream out(std::ios::binary);
+  EXPECT_TRUE(camera_calibration_parsers::writeCalibrationBin(out, camera_name, ci));
+  return out.str();
+}
+
+TEST(ParseBin, roundtrip) {
+  for (const char * model : {sensor_msgs::distortion_models::PLUMB_BOB,
+      sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL})
+  {
+    auto cam_info = make_calib(model, true);
+    cam_info.k[0] = 0.1;
+    cam_info.p[3] = -std::numeric_limits<double>::denorm_min();
+    std::string buffer = writeBin("roundtrip_bin", cam_info);
+    ASSERT_EQ(buffer.substr(0, 4), "CCAL");
+
+    std::string camera_name;
+    sensor_msgs::msg::CameraInfo cam_info2;
+    ASSERT_TRUE(camera_calibration_parsers::parseCalibrationBin(buffer, camera_name, cam_info2));
+    EXPECT_EQ(camera_name, "roundtrip_bin");
+    EXPECT_EQ(cam_info2, cam_info);
+  }
+}
+
+TEST(ParseBin, rejects_damaged_data) {
+  auto cam_info = make_calib(sensor_msgs::distortion_models::PLUMB_BOB);
+  const std::string buffer = writeBin("damaged", cam_info);
+  std::string camera_name = "untouched";
+  sensor_msgs::msg::CameraInfo out;
+
+  // Any flipped bit is caught by the magic number, version or checksum.
+  for (size_t i = 0; i < buffer.size(); i += 7) {
+    std::string corrupt = buffer;
+    corrupt[i] = static_cast<char>(corrupt[i] ^ 0x10);
+    EXPECT_FALSE(camera_calibration_parsers::parseCalibrationBin(corrupt, camera_name, out)) << i;
+  }
+  for (size_t size : {size_t(0), size_t(4), size_t(16), buffer.size() - 1}) {
+    EXPECT_FALSE(
+      camera_calibration_parsers::parseCalibrationBin(
+        std::string_view(buffer).substr(0, size), camera_name, out)) << size;
+  }
+  EXPECT_EQ(camera_name, "untouched");
+  EXPECT_TRUE(out.d.empty());
+
+  // Unknown versions are refused even when intact.
+  std::string v2 = buffer;
+  v2[4] = 2;
+  EXPECT_FALSE(camera_calibration_parsers::parseCalibrationBin(v2, camera_name, out));
+  // So are nonzero reserved fields.
+  std::string reserved = buffer;
+  reserved[6] = 1;
+  EXPECT_FALSE(camera_calibration_parsers::parseCalibrationBin(reserved, camera_name, out));
+}
+
+TEST(ParseBin, replaces_existing_file) {
+  auto cam_info = make_calib(sensor_msgs::distortion_models::PLUMB_BOB);
+  std::string calib_file = custom_tmpnam() + ".ccal";
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationBin(calib_file, "first", cam_info));
+  const auto perms = std::filesystem::perms::owner_read | std::filesystem::perms::owner_write |
+    std::filesystem::perms::group_read;
+  std::filesystem::permissions(calib_file, perms);
+
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationBin(calib_file, "second", cam_info));
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info2;
+  ASSERT_TRUE(camera_calibration_parsers::readCalibration(calib_file, camera_name, cam_info2));
+  EXPECT_EQ(camera_name, "second");
+  check_calib(cam_info2);
+#ifndef _WIN32
+  // The replacement keeps the permissions of the file it replaces.
+  EXPECT_EQ(std::filesystem::status(calib_file).permissions(), perms);
+#endif
+
+  std::remove(calib_file.c_str());
+}
+
+TEST(ParseBin, dispatch_by_extension_and_magic) {
+  auto cam_info = make_calib(sensor_msgs::distortion_models::PLUMB_BOB);
+
+  std::string calib_file = custom_tmpnam() + ".ccal";
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibration(calib_file, "by_extension", cam_info));
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info2;
+  ASSERT_TRUE(camera_calibration_parsers::readCalibration(calib_file, camera_name, cam_info2));
+  EXPECT_EQ(camera_name, "by_extension");
+  check_calib(cam_info2);
+
+  // Without a known extension the magic number identifies the format.
+  std::string other_file = custom_tmpnam();
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationBin(other_file, "by_magic", cam_info));
+  ASSERT_TRUE(camera_calibration_parsers::readCalibration(other_file, camera_name, cam_info2));
+  EXPECT_EQ(camera_name, "by_magic");
+  check_calib(cam_info2);
+
+  std::string buffer = writeBin("in_memory", cam_info);
+  EXPECT_EQ(camera_calibration_parsers::detectCalibrationFormat(buffer), "bin");
+  ASSERT_TRUE(
+    camera_calibration_parsers::parseCalibration(std::string_view(buffer), camera_name, cam_info2));
+  EXPECT_EQ(camera_name, "in_memory");
+
+  std::remove(calib_file.c_str());
+  std::remove(other_file.c_str());
+}
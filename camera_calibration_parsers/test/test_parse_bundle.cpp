@@ -0,0 +1,180 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_calibration_parsers/parse_bundle.hpp"
+#include "sensor_msgs/distortion_models.hpp"
+#include "sensor_msgs/msg/camera_info.hpp"
+
+#include "make_calibs.hpp"
+
+std::string custom_tmpnam()
+{
+#ifdef _WIN32
+  char name[L_tmpnam_s];
+  errno_t err = tmpnam_s(name, L_tmpnam_s);
+  if (err) {
+    printf("Error occured creating unique filename.\n");
+  }
+  return std::string(name);
+#else
+  char temp[] = "/tmp/calib.XXXXXX";
+  int fd = mkstemp(temp);
+  close(fd);
+  return std::string(temp);
+#endif
+}
+
+static std::map<std::string, sensor_msgs::msg::CameraInfo> make_bundle()
+{
+  return {
+    {"front_left", make_calib(sensor_msgs::distortion_models::PLUMB_BOB)},
+    {"front_right", make_calib(sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL)},
+    {"rear", make_calib(sensor_msgs::distortion_models::PLUMB_BOB)},
+  };
+}
+
+TEST(ParseBundle, roundtrip_all) {
+  std::string bundle_file = custom_tmpnam();
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationBundle(bundle_file, make_bundle()));
+
+  std::map<std::string, sensor_msgs::msg::CameraInfo> cam_infos;
+  ASSERT_TRUE(camera_calibration_parsers::readCalibrationBundle(bundle_file, cam_infos));
+  ASSERT_EQ(cam_infos.size(), 3U);
+  for (const auto & entry : cam_infos) {
+    check_calib(entry.second);
+  }
+  EXPECT_EQ(
+    cam_infos["front_right"].distortion_model,
+    sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL);
+}
+
+TEST(ParseBundle, read_one_camera) {
+  std::string bundle_file = custom_tmpnam();
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationBundle(bundle_file, make_bundle()));
+
+  auto bundle = camera_calibration_parsers::CalibrationBundle::open(bundle_file);
+  ASSERT_NE(bundle, nullptr);
+  EXPECT_EQ(
+    bundle->cameras(), (std::vector<std::string>{"front_left", "front_right", "rear"}));
+  EXPECT_TRUE(bundle->has("rear"));
+  EXPECT_FALSE(bundle->has("top"));
+  EXPECT_TRUE(bundle->record("top").empty());
+
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info;
+  ASSERT_TRUE(bundle->read("rear", camera_name, cam_info));
+  EXPECT_EQ(camera_name, "rear");
+  check_calib(cam_info);
+  EXPECT_FALSE(bundle->read("top", camera_name, cam_info));
+}
+
+TEST(ParseBundle, update_one_camera) {
+  std::string bundle_file = custom_tmpnam();
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationBundle(bundle_file, make_bundle()));
+  std::string rear_record(
+    camera_calibration_parsers::CalibrationBundle::open(bundle_file)->record("rear"));
+
+  auto cam_info = make_calib(sensor_msgs::distortion_models::PLUMB_BOB);
+  cam_info.width = 1280;
+  ASSERT_TRUE(
+    camera_calibration_parsers::writeCalibrationBundle(
+      bundle_file, "front_left", "replacement", cam_info));
+  ASSERT_TRUE(
+    camera_calibration_parsers::writeCalibrationBundle(
+      bundle_file, "top", "top", cam_info));
+
+  auto bundle = camera_calibration_parsers::CalibrationBundle::open(bundle_file);
+  ASSERT_NE(bundle, nullptr);
+  EXPECT_EQ(
+    bundle->cameras(),
+    (std::vector<std::string>{"front_left", "front_right", "rear", "top"}));
+  // Records of other cameras are carried over byte for byte.
+  EXPECT_EQ(bundle->record("rear"), rear_record);
+
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info2;
+  ASSERT_TRUE(bundle->read("front_left", camera_name, cam_info2));
+  EXPECT_EQ(camera_name, "replacement");
+  EXPECT_EQ(cam_info2.width, 1280U);
+}
+
+TEST(ParseBundle, invalid_bundle) {
+  std::string bundle_file = custom_tmpnam();
+  {
+    std::ofstream out(bundle_file);
+    out << "image_width: 640\n";
+  }
+  EXPECT_EQ(camera_calibration_parsers::CalibrationBundle::open(bundle_file), nullptr);
+  // A file that is not a bundle is never replaced.
+  EXPECT_FALSE(
+    camera_calibration_parsers::writeCalibrationBundle(
+      bundle_file, "rear", "rear", make_calib(sensor_msgs::distortion_models::PLUMB_BOB)));
+  EXPECT_FALSE(
+    camera_calibration_parsers::writeCalibrationBundle(
+      custom_tmpnam(), "bad name", "rear",
+      make_calib(sensor_msgs::distortion_models::PLUMB_BOB)));
+
+  {
+    std::ofstream out(bundle_file);
+    out << "%CALIBRATION_BUNDLE 1 1\nrear 0 1000\n%END\nshort";
+  }
+  EXPECT_EQ(camera_calibration_parsers::CalibrationBundle::open(bundle_file), nullptr);
+}
+
+TEST(ParseBundle, concurrent_updates) {
+  std::string bundle_file = custom_tmpnam();
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationBundle(bundle_file, make_bundle()));
+
+  // Every thread updates its own camera, none of the updates may be lost.
+  const int kThreads = 8;
+  const int kUpdates = 20;
+  std::vector<std::thread> threads;
+  std::vector<int> failures(kThreads, 0);
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back(
+      [&, i]() {
+        const std::string camera = "camera_" + std::to_string(i);
+        auto cam_info = make_calib(sensor_msgs::distortion_models::PLUMB_BOB);
+        for (int update = 1; update <= kUpdates; ++update) {
+          cam_info.width = static_cast<uint32_t>(100 * i + update);
+          if (!camera_calibration_parsers::writeCalibrationBundle(
+              bundle_file, camera, camera, cam_info))
+          {
+            ++failures[i];
+          }
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  std::map<std::string, sensor_msgs::msg::CameraInfo> cam_infos;
+  ASSERT_TRUE(camera_calibration_parsers::readCalibrationBundle(bundle_file, cam_infos));
+  EXPECT_EQ(cam_infos.size(), 3U + kThreads);
+  for (int i = 0; i < kThreads; ++i) {
+    EXPECT_EQ(failures[i], 0);
+    EXPECT_EQ(cam_infos["camera_" + std::to_string(i)].width, 100U * i + kUpdates);
+  }
+}
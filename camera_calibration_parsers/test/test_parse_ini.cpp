@@ -16,6 +16,7 @@
 
 #include <cstdio>
 #include <string>
+#include <string_view>
 
 #include "camera_calibration_parsers/parse_ini.hpp"
 #include "sensor_msgs/distortion_models.hpp"
@@ -247,3 +248,29 @@ TEST(ParseIni, cant_write_calib8) {
     camera_calibration_parsers::writeCalibrationIni(calib_file, camera_name, cam_info);
   ASSERT_EQ(ret_write, false);
 }
+
+TEST(ParseIni, parse_string_view) {
+  // The view does not need to be null terminated: parse a calibration embedded in a larger buffer.
+  std::string buffer = std::string("garbage") + kValidCalib8 + "[trailing";
+  std::string_view view(buffer);
+  view.remove_prefix(7);
+  view.remove_suffix(9);
+
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info;
+  ASSERT_TRUE(camera_calibration_parsers::parseCalibrationIni(view, camera_name, cam_info));
+  ASSERT_EQ(camera_name, "mono_left");
+  check_calib(cam_info);
+}
+
+TEST(ParseIni, parse_invalid_distortion_leaves_output) {
+  std::string calib = kValidCalib5;
+  calib.replace(calib.find("1 2 3 4 5\n"), 9, "1 2 3 4 5 6");
+
+  std::string camera_name = "untouched";
+  sensor_msgs::msg::CameraInfo cam_info;
+  ASSERT_FALSE(camera_calibration_parsers::parseCalibrationIni(calib, camera_name, cam_info));
+  ASSERT_EQ(camera_name, "untouched");
+  ASSERT_EQ(cam_info.width, 0U);
+  ASSERT_TRUE(cam_info.d.empty());
+}
@@ -16,6 +16,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <string>
 
 #include "camera_calibration_parsers/parse_yml.hpp"
@@ -23,6 +24,7 @@
 #include "sensor_msgs/msg/camera_info.hpp"
 
 #include "make_calibs.hpp"
+#include "parse_yml_stream.hpp"
 
 std::string custom_tmpnam()
 {
@@ -233,3 +235,172 @@ TEST(ParseYml, roundtrip_calib_roi) {
   ASSERT_EQ(camera_name2, camera_name);
   check_calib(cam_info2);
 }
+
+static const char * kValidCalibBlock =
+  R"(# written by hand
+image_width: 640
+image_height: 480
+camera_name: mono_left  # left camera
+camera_matrix:
+    rows: 3
+    cols: 3
+    dt: d
+    data:
+    - 1
+    - 2
+    - 3
+    - 4
+    - 5
+    - 6
+    - 7
+    - 8
+    - 9
+distortion_model: plumb_bob
+distortion_coefficients:
+  rows: 1
+  cols: 5
+  data:
+    - 1.0
+    - 2.0e0
+    - 3
+    - 4
+    - 5
+rectification_matrix:
+  rows: 3
+  cols: 3
+  data: [1, 0, 0,
+    0, 1, 0,
+    0, 0, 1]
+
+projection_matrix:
+  rows: 3
+  cols: 4
+  data: [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12]
+calibration_notes:
+  operator: someone
+)";
+
+TEST(ParseYml, stream_parser_block_and_multiline_sequences) {
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info;
+  ASSERT_TRUE(
+    camera_calibration_parsers::impl::parseCalibrationYmlStream(
+      kValidCalibBlock, camera_name, cam_info));
+  ASSERT_EQ(camera_name, "mono_left");
+  check_calib(cam_info);
+}
+
+TEST(ParseYml, stream_parser_matches_dom) {
+  for (const char * calib : {kValidCalib5, kValidCalib8, kValidCalibRoi, kValidCalibBlock}) {
+    std::string stream_name, dom_name;
+    sensor_msgs::msg::CameraInfo stream_info, dom_info;
+    ASSERT_TRUE(
+      camera_calibration_parsers::impl::parseCalibrationYmlStream(
+        calib, stream_name, stream_info));
+    ASSERT_TRUE(
+      camera_calibration_parsers::impl::parseCalibrationYmlDom(
+        calib, dom_name, dom_info));
+    EXPECT_EQ(stream_name, dom_name);
+    EXPECT_EQ(stream_info, dom_info);
+  }
+}
+
+TEST(ParseYml, stream_parser_falls_back) {
+  // Valid YAML outside the subset the streaming parser handles.
+  std::string quoted = kValidCalib5;
+  quoted.replace(quoted.find("mono_left"), 9, "\"mono_left\"");
+  std::string flow_map = std::string(kValidCalib5) + "roi: {x_offset: 20, y_offset: 180, "
+    "height: 300, width: 600, do_rectify: true}\n";
+
+  for (const std::string & calib : {quoted, flow_map}) {
+    std::string camera_name;
+    sensor_msgs::msg::CameraInfo cam_info;
+    EXPECT_FALSE(
+      camera_calibration_parsers::impl::parseCalibrationYmlStream(
+        calib, camera_name, cam_info));
+    EXPECT_TRUE(cam_info.d.empty());
+    ASSERT_TRUE(camera_calibration_parsers::parseCalibrationYml(calib, camera_name, cam_info));
+    EXPECT_EQ(camera_name, "mono_left");
+    check_calib(cam_info);
+  }
+
+  // yaml-cpp reads integers with a leading zero as octal.
+  {
+    std::string octal = kValidCalib5;
+    octal.replace(octal.find("640"), 3, "0640");
+    std::string camera_name;
+    sensor_msgs::msg::CameraInfo cam_info;
+    EXPECT_FALSE(
+      camera_calibration_parsers::impl::parseCalibrationYmlStream(
+        octal, camera_name, cam_info));
+    ASSERT_TRUE(camera_calibration_parsers::parseCalibrationYml(octal, camera_name, cam_info));
+    EXPECT_EQ(cam_info.width, 0640U);
+  }
+
+  // Invalid calibrations are left to the DOM parser to report.
+  std::string short_data = kValidCalib5;
+  short_data.replace(short_data.find("[1, 2, 3, 4, 5]"), 15, "[1, 2, 3, 4]");
+  std::string misaligned = kValidCalib5;
+  misaligned.replace(
+    misaligned.find("[1, 2, 3, 4, 5]"), 15, "\n    - 1\n    - 2\n   - 3\n    - 4\n    - 5");
+  std::string map_value = kValidCalib5;
+  map_value.replace(map_value.find("plumb_bob"), 9, "plumb_bob:");
+  std::string unknown_block = std::string(kValidCalib5) + "extra:\n  data: [1, 0,\n";
+
+  for (const std::string & calib :
+    {std::string(kInvalidCalib5), short_data, misaligned, map_value, unknown_block})
+  {
+    std::string camera_name;
+    sensor_msgs::msg::CameraInfo cam_info;
+    EXPECT_FALSE(
+      camera_calibration_parsers::impl::parseCalibrationYmlStream(
+        calib, camera_name, cam_info));
+    EXPECT_FALSE(camera_calibration_parsers::parseCalibrationYml(calib, camera_name, cam_info));
+  }
+}
+
+TEST(ParseYml, dom_parser_rejects_bad_shapes) {
+  auto with = [](const char * from, const char * to) {
+      std::string calib = kValidCalib5;
+      calib.replace(calib.find(from), std::string(from).size(), to);
+      return calib;
+    };
+  const std::string bad[] = {
+    with("rows: 3\n  cols: 3\n  data: [1, 2", "rows: 100\n  cols: 3\n  data: [1, 2"),
+    with("rows: 3\n  cols: 4", "rows: 4\n  cols: 3"),
+    with("cols: 5", "cols: -1"),
+    with("cols: 5", "cols: 1000000"),
+    with("data: [1, 2, 3, 4, 5]\n", "data: 5\n"),
+  };
+
+  for (const std::string & calib : bad) {
+    std::string camera_name = "unchanged";
+    sensor_msgs::msg::CameraInfo cam_info;
+    EXPECT_FALSE(
+      camera_calibration_parsers::impl::parseCalibrationYmlDom(calib, camera_name, cam_info));
+    EXPECT_FALSE(camera_calibration_parsers::parseCalibrationYml(calib, camera_name, cam_info));
+    EXPECT_EQ(camera_name, "unchanged");
+    EXPECT_EQ(cam_info, sensor_msgs::msg::CameraInfo());
+  }
+}
+
+TEST(ParseYml, read_large_file) {
+  // Large enough to be memory-mapped rather than read.
+  std::string calib_file = custom_tmpnam();
+  {
+    std::ofstream out(calib_file);
+    for (int i = 0; i < 2000; ++i) {
+      out << "# padding comment line " << i << " to push the file past the mapping threshold\n";
+    }
+    out << kValidCalibRoi;
+  }
+
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo cam_info;
+  ASSERT_TRUE(camera_calibration_parsers::readCalibrationYml(calib_file, camera_name, cam_info));
+  ASSERT_EQ(camera_name, "mono_left");
+  check_calib(cam_info);
+  std::remove(calib_file.c_str());
+
+  ASSERT_FALSE(camera_calibration_parsers::readCalibrationYml(calib_file, camera_name, cam_info));
+}
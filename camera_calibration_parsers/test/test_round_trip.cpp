@@ -0,0 +1,204 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "camera_calibration_parsers/parse_ini.hpp"
+#include "camera_calibration_parsers/parse_yml.hpp"
+#include "sensor_msgs/distortion_models.hpp"
+#include "sensor_msgs/msg/camera_info.hpp"
+
+// Values that are easy to get wrong: no short decimal form, extremes, subnormals, signed zero.
+static const std::vector<double> kEdgeValues = {
+  0.1, 1.0 / 3.0, 2.0 / 3.0, 1e-5, 123456.789012345678, 369.344588, -0.018229,
+  0.0, -0.0, 1.0, -1.0, 1e22, 1e23, 5e-324, 2.2250738585072014e-308,
+  std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(),
+  std::numeric_limits<double>::min(), std::numeric_limits<double>::epsilon(),
+};
+
+static bool sameBits(double a, double b)
+{
+  return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// Fill a calibration with random finite doubles drawn over the whole bit range.
+static sensor_msgs::msg::CameraInfo randomCalib(std::mt19937_64 & rng, size_t d_size)
+{
+  auto next = [&rng]() {
+      for (;;) {
+        uint64_t bits = rng();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (std::isfinite(value)) {
+          return value;
+        }
+      }
+    };
+  sensor_msgs::msg::CameraInfo cam_info;
+  cam_info.width = 1920;
+  cam_info.height = 1080;
+  cam_info.distortion_model = d_size == 5 ?
+    sensor_msgs::distortion_models::PLUMB_BOB :
+    sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL;
+  cam_info.d.resize(d_size);
+  for (double & v : cam_info.d) {
+    v = next();
+  }
+  for (double & v : cam_info.k) {
+    v = next();
+  }
+  for (double & v : cam_info.r) {
+    v = next();
+  }
+  for (double & v : cam_info.p) {
+    v = next();
+  }
+  return cam_info;
+}
+
+static void expectBitIdentical(
+  const sensor_msgs::msg::CameraInfo & expected,
+  const sensor_msgs::msg::CameraInfo & actual)
+{
+  ASSERT_EQ(expected.d.size(), actual.d.size());
+  for (size_t i = 0; i < expected.d.size(); ++i) {
+    EXPECT_TRUE(sameBits(expected.d[i], actual.d[i])) << "d[" << i << "] " << expected.d[i];
+  }
+  for (size_t i = 0; i < 9; ++i) {
+    EXPECT_TRUE(sameBits(expected.k[i], actual.k[i])) << "k[" << i << "] " << expected.k[i];
+    EXPECT_TRUE(sameBits(expected.r[i], actual.r[i])) << "r[" << i << "] " << expected.r[i];
+  }
+  for (size_t i = 0; i < 12; ++i) {
+    EXPECT_TRUE(sameBits(expected.p[i], actual.p[i])) << "p[" << i << "] " << expected.p[i];
+  }
+}
+
+TEST(RoundTrip, yml_edge_values) {
+  sensor_msgs::msg::CameraInfo cam_info;
+  cam_info.distortion_model = sensor_msgs::distortion_models::RATIONAL_POLYNOMIAL;
+  cam_info.d = kEdgeValues;
+  for (size_t i = 0; i < 12; ++i) {
+    cam_info.p[i] = kEdgeValues[i];
+    cam_info.k[i % 9] = kEdgeValues[kEdgeValues.size() - 1 - i % 9];
+    cam_info.r[i % 9] = -kEdgeValues[i % 9];
+  }
+
+  std::stringstream ss;
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationYml(ss, "edge", cam_info));
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo read_back;
+  ASSERT_TRUE(camera_calibration_parsers::readCalibrationYml(ss, camera_name, read_back));
+  expectBitIdentical(cam_info, read_back);
+}
+
+TEST(RoundTrip, yml_non_finite) {
+  sensor_msgs::msg::CameraInfo cam_info;
+  cam_info.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
+  cam_info.d = {std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+    std::numeric_limits<double>::quiet_NaN(), 0.0, 0.0};
+
+  std::stringstream ss;
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationYml(ss, "non_finite", cam_info));
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo read_back;
+  ASSERT_TRUE(camera_calibration_parsers::readCalibrationYml(ss, camera_name, read_back));
+  ASSERT_EQ(read_back.d.size(), 5U);
+  EXPECT_EQ(read_back.d[0], std::numeric_limits<double>::infinity());
+  EXPECT_EQ(read_back.d[1], -std::numeric_limits<double>::infinity());
+  EXPECT_TRUE(std::isnan(read_back.d[2]));
+}
+
+TEST(RoundTrip, yml_camera_names) {
+  auto cam_info = sensor_msgs::msg::CameraInfo();
+  cam_info.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
+  cam_info.d.resize(5);
+  for (const char * name : {"narrow_stereo/left", "null", "true", "123", "with space",
+      "quote'd", "colon: here", "-dash", "#hash", ""})
+  {
+    std::stringstream ss;
+    ASSERT_TRUE(camera_calibration_parsers::writeCalibrationYml(ss, name, cam_info));
+    std::string camera_name;
+    sensor_msgs::msg::CameraInfo read_back;
+    ASSERT_TRUE(camera_calibration_parsers::readCalibrationYml(ss, camera_name, read_back));
+    EXPECT_EQ(camera_name, name);
+  }
+}
+
+TEST(RoundTrip, yml_random) {
+  std::mt19937_64 rng(42);
+  for (int i = 0; i < 200; ++i) {
+    auto cam_info = randomCalib(rng, i % 2 ? 8 : 5);
+    std::stringstream ss;
+    ASSERT_TRUE(camera_calibration_parsers::writeCalibrationYml(ss, "random", cam_info));
+    std::string text = ss.str();
+
+    std::string camera_name;
+    sensor_msgs::msg::CameraInfo read_back;
+    ASSERT_TRUE(camera_calibration_parsers::parseCalibrationYml(text, camera_name, read_back));
+    expectBitIdentical(cam_info, read_back);
+
+    // Writing what was read gives the same text again.
+    std::stringstream ss2;
+    ASSERT_TRUE(camera_calibration_parsers::writeCalibrationYml(ss2, camera_name, read_back));
+    EXPECT_EQ(ss2.str(), text);
+  }
+}
+
+TEST(RoundTrip, ini_edge_values) {
+  sensor_msgs::msg::CameraInfo cam_info;
+  cam_info.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
+  cam_info.d.assign(kEdgeValues.begin(), kEdgeValues.begin() + 5);
+  for (size_t i = 0; i < 12; ++i) {
+    cam_info.p[i] = kEdgeValues[kEdgeValues.size() - 1 - i];
+    cam_info.k[i % 9] = kEdgeValues[i % 9];
+    cam_info.r[i % 9] = -kEdgeValues[5 + i % 9];
+  }
+
+  std::stringstream ss;
+  ASSERT_TRUE(camera_calibration_parsers::writeCalibrationIni(ss, "edge", cam_info));
+  std::string camera_name;
+  sensor_msgs::msg::CameraInfo read_back;
+  ASSERT_TRUE(camera_calibration_parsers::readCalibrationIni(ss, camera_name, read_back));
+  expectBitIdentical(cam_info, read_back);
+}
+
+TEST(RoundTrip, ini_random) {
+  std::mt19937_64 rng(7);
+  for (int i = 0; i < 200; ++i) {
+    auto cam_info = randomCalib(rng, 5);
+    std::stringstream ss;
+    ASSERT_TRUE(camera_calibration_parsers::writeCalibrationIni(ss, "random", cam_info));
+    std::string text = ss.str();
+
+    std::string camera_name;
+    sensor_msgs::msg::CameraInfo read_back;
+    ASSERT_TRUE(camera_calibration_parsers::parseCalibrationIni(text, camera_name, read_back));
+    EXPECT_EQ(read_back.width, cam_info.width);
+    EXPECT_EQ(read_back.height, cam_info.height);
+    expectBitIdentical(cam_info, read_back);
+
+    std::stringstream ss2;
+    ASSERT_TRUE(camera_calibration_parsers::writeCalibrationIni(ss2, camera_name, read_back));
+    EXPECT_EQ(ss2.str(), text);
+  }
+}
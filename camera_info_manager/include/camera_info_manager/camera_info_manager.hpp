@@ -38,9 +38,16 @@
 #ifndef CAMERA_INFO_MANAGER__CAMERA_INFO_MANAGER_HPP_
 #define CAMERA_INFO_MANAGER__CAMERA_INFO_MANAGER_HPP_
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "rclcpp/node.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
@@ -80,6 +87,16 @@ using SetCameraInfo = sensor_msgs::srv::SetCameraInfo;
     some thread, so CameraInfoManager can handle arriving service
     requests.
 
+    The new CameraInfo takes effect as soon as the request arrives,
+    but it is saved by a background writer thread, so the executor
+    serving the camera's image callbacks never waits on file I/O.
+    The service response is sent once the save completes. Requests
+    arriving while a save is pending are coalesced into a single
+    write of the latest calibration. Files are replaced atomically
+    via a temporary file, and left untouched when their content
+    would not change. Use setSaveCallback() to be told about the
+    outcome of each save.
+
     @par Camera Name
 
     The device driver sets a camera name via the
@@ -125,12 +142,19 @@ using SetCameraInfo = sensor_msgs::srv::SetCameraInfo;
     - file:///full/path/to/videre/file.ini
     - package://camera_info_manager/tests/test_calibration.yaml
     - package://ros_package_name/calibrations/camera3.yaml
+    - bundle:///full/path/to/fleet.calib#camera3
 
     The @c file: URL specifies a full path name in the local system.
     The @c package: URL is handled the same as @c file:, except the
     path name is resolved relative to the location of the named ROS
     package, which @em must be reachable via @c $ROS_PACKAGE_PATH.
 
+    The @c bundle: URL names one camera, after the '#', in a
+    calibration bundle holding many cameras in one indexed file (see
+    camera_calibration_parsers::CalibrationBundle). Only that
+    camera's record is decoded on load and rewritten on save.
+    Bundles are not watched for changes.
+
     Beginning with Electric Emys, the URL may contain substitution
     variables delimited by <tt>${...}</tt>, including:
 
@@ -177,22 +201,63 @@ using SetCameraInfo = sensor_msgs::srv::SetCameraInfo;
     or @c isCalibrated(). To avoid that, do an explicit @c
     loadCameraInfo() first.
 
+    Alternatively, pass a LoadMode other than LoadMode::Lazy to the
+    constructor to start loading in a background thread right away,
+    keeping URL resolution, package lookup and file parsing off the
+    driver's capture thread. With LoadMode::Background the getters
+    wait for that load to finish, with LoadMode::BackgroundNonBlocking
+    they return immediately: getCameraInfo() gives an empty
+    CameraInfo, isCalibrated() false and getCameraInfoSnapshot() a
+    null pointer until the calibration is loaded.
+
+    @par Watching for Changes
+
+    On Linux, startWatching() makes CameraInfoManager watch the file
+    the current @c file: or @c package: URL resolves to. When the
+    file is changed, replaced or created, it is parsed in a
+    background thread once changes have settled for the debounce
+    period, then swapped in like a @c set_camera_info request,
+    without saving. The calibration callback is called with the new
+    data. Changes of URL or camera name move the watch along.
+
 */
 
 class CameraInfoManager
 {
 public:
+  /** @brief Called from the writer thread when a calibration save completes.
+   *
+   *  @param success whether the calibration was stored
+   *  @param message empty on success, otherwise the reason for failure
+   */
+  using SaveCallback = std::function<void (bool success, const std::string & message)>;
+
+  /** @brief Called from the watcher thread when the calibration
+   *         file changed, with the new data.
+   */
+  using CalibrationCallback = std::function<void (const CameraInfo::ConstSharedPtr & info)>;
+
+  /** @brief When the calibration is loaded. */
+  enum class LoadMode
+  {
+    Lazy,                    ///< on first use (the default)
+    Background,              ///< in the constructor, getters wait for it
+    BackgroundNonBlocking,   ///< in the constructor, getters never wait
+  };
+
   CAMERA_INFO_MANAGER_PUBLIC
   CameraInfoManager(
     rclcpp::Node * node,
     const std::string & cname = "camera",
-    const std::string & url = "");
+    const std::string & url = "",
+    LoadMode load_mode = LoadMode::Lazy);
 
   CAMERA_INFO_MANAGER_PUBLIC
   CameraInfoManager(
     rclcpp_lifecycle::LifecycleNode * node,
     const std::string & cname = "camera",
-    const std::string & url = "");
+    const std::string & url = "",
+    LoadMode load_mode = LoadMode::Lazy);
 
   CAMERA_INFO_MANAGER_PUBLIC
   CameraInfoManager(
@@ -200,11 +265,18 @@ public:
     rclcpp::node_interfaces::NodeServicesInterface::SharedPtr node_services_interface,
     rclcpp::node_interfaces::NodeLoggingInterface::SharedPtr node_logger_interface,
     const std::string & cname = "camera", const std::string & url = "",
-    rmw_qos_profile_t custom_qos = rmw_qos_profile_default);
+    rmw_qos_profile_t custom_qos = rmw_qos_profile_default,
+    LoadMode load_mode = LoadMode::Lazy);
+
+  CAMERA_INFO_MANAGER_PUBLIC
+  ~CameraInfoManager();
 
   CAMERA_INFO_MANAGER_PUBLIC
   CameraInfo getCameraInfo(void);
 
+  CAMERA_INFO_MANAGER_PUBLIC
+  CameraInfo::ConstSharedPtr getCameraInfoSnapshot(void);
+
   CAMERA_INFO_MANAGER_PUBLIC
   bool isCalibrated(void);
 
@@ -222,6 +294,18 @@ public:
   CAMERA_INFO_MANAGER_PUBLIC
   bool setCameraInfo(const CameraInfo & camera_info);
 
+  CAMERA_INFO_MANAGER_PUBLIC
+  void setSaveCallback(const SaveCallback & callback);
+
+  CAMERA_INFO_MANAGER_PUBLIC
+  void setCalibrationCallback(const CalibrationCallback & callback);
+
+  CAMERA_INFO_MANAGER_PUBLIC
+  bool startWatching(std::chrono::milliseconds debounce = std::chrono::milliseconds(200));
+
+  CAMERA_INFO_MANAGER_PUBLIC
+  void stopWatching();
+
   CAMERA_INFO_MANAGER_PUBLIC
   bool validateURL(const std::string & url);
 
@@ -233,14 +317,28 @@ private:
     URL_empty = 0,               // empty string
     URL_file,                    // file:
     URL_package,                 // package:
+    URL_bundle,                  // bundle:
     // URLs not supported
     URL_invalid,                 // anything >= is invalid
     URL_flash,                   // flash:
   } url_type_t;
 
+  /** @brief a URL resolved for a camera name */
+  struct ResolvedLocation
+  {
+    std::string url;                    ///< URL as given
+    std::string cname;                  ///< camera name it was resolved for
+    std::string resolved;               ///< URL with variables substituted
+    url_type_t type;                    ///< type of the resolved URL
+  };
+
   // private methods
   std::string getPackageFileName(const std::string & url);
 
+  std::string getCalibrationFileName(
+    const std::string & url,
+    const std::string & cname);
+
   bool loadCalibration(
     const std::string & url,
     const std::string & cname);
@@ -249,21 +347,61 @@ private:
     const std::string & filename,
     const std::string & cname);
 
+  bool loadCalibrationBundle(
+    const std::string & url,
+    const std::string & cname);
+
   url_type_t parseURL(const std::string & url);
 
+  std::shared_ptr<const ResolvedLocation> resolveLocation(
+    const std::string & url,
+    const std::string & cname);
+
+  std::shared_ptr<const ResolvedLocation> compileLocation(
+    const std::string & url,
+    const std::string & cname);
+
   bool saveCalibration(
     const CameraInfo & new_info,
     const std::string & url,
     const std::string & cname);
 
+  void publishSnapshot();
+
+  bool waitForBackgroundLoad(std::unique_lock<std::mutex> & lock, bool block);
+
+  bool saveCalibrationBundle(
+    const CameraInfo & new_info,
+    const std::string & url,
+    const std::string & cname);
+
   bool saveCalibrationFile(
     const CameraInfo & new_info,
     const std::string & filename,
     const std::string & cname);
 
   void setCameraInfoService(
-    const std::shared_ptr<SetCameraInfo::Request> req,
-    std::shared_ptr<SetCameraInfo::Response> rsp);
+    const std::shared_ptr<rmw_request_id_t> request_header,
+    const std::shared_ptr<SetCameraInfo::Request> req);
+
+  void writerThread();
+
+  void watchThread();
+
+  void wakeWatcher();
+
+  void reloadWatchedFile(const std::string & filename);
+
+  /** @brief A calibration waiting for the writer thread, with the
+   *         service requests to answer once it is stored.
+   */
+  struct PendingSave
+  {
+    CameraInfo camera_info;
+    std::string url;
+    std::string cname;
+    std::vector<std::shared_ptr<rmw_request_id_t>> requests;
+  };
 
   /** @brief mutual exclusion lock for private data
    *
@@ -281,7 +419,46 @@ private:
   std::string camera_name_;             ///< camera name
   std::string url_;                     ///< URL for calibration data
   CameraInfo cam_info_;    ///< current CameraInfo
+
+  /** @brief immutable copy of cam_info_, replaced on every update
+   *
+   *  Accessed only with std::atomic_load() and std::atomic_store(),
+   *  so readers never take mutex_. Null until loaded, and again
+   *  after a camera name change forces a reload.
+   */
+  CameraInfo::ConstSharedPtr cam_info_snapshot_;
+
+  /** @brief last resolved URL and default URL
+   *
+   *  Accessed only with std::atomic_load() and std::atomic_store().
+   *  Resolved again only when the URL or camera name differ.
+   */
+  std::shared_ptr<const ResolvedLocation> location_;
+  std::shared_ptr<const ResolvedLocation> default_location_;
   bool loaded_cam_info_;                ///< cam_info_ load attempted
+  LoadMode load_mode_;                  ///< constructor load mode
+  bool loading_ = false;                ///< background load in progress
+  std::condition_variable loaded_cv_;   ///< signals loading_ cleared, uses mutex_
+  std::thread load_thread_;             ///< background load
+
+  /** @brief lock for the writer thread state below
+   *
+   *  Never held together with mutex_, during I/O or while invoking
+   *  the save callback.
+   */
+  std::mutex save_mutex_;
+  std::condition_variable save_cv_;     ///< signals pending_save_ or stop_writer_
+  std::optional<PendingSave> pending_save_;  ///< latest calibration to store
+  SaveCallback save_callback_;          ///< save completion callback
+  bool stop_writer_ = false;            ///< writer thread exits once drained
+  std::thread writer_;                  ///< started by the first save
+
+  // calibration file watching
+  CalibrationCallback calibration_callback_;  ///< uses mutex_
+  std::chrono::milliseconds watch_debounce_{200};  ///< quiet time before reload
+  std::atomic<bool> stop_watching_{false};  ///< watcher thread exits
+  std::atomic<int> watch_wake_fd_{-1};  ///< wakes the watcher, open until destruction
+  std::thread watch_thread_;            ///< started by startWatching()
 };  // class CameraInfoManager
 }  // namespace camera_info_manager
 
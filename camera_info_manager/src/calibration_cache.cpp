@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "calibration_cache.hpp"
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "camera_calibration_parsers/parse.hpp"
+
+namespace camera_info_manager
+{
+namespace impl
+{
+
+CalibrationCache & CalibrationCache::instance()
+{
+  // Leaked, managers may still use it during static destruction.
+  static CalibrationCache * cache = new CalibrationCache;
+  return *cache;
+}
+
+bool CalibrationCache::read(
+  const std::string & filename,
+  std::string & camera_name,
+  sensor_msgs::msg::CameraInfo::ConstSharedPtr & camera_info)
+{
+  const std::string key = std::filesystem::path(filename).lexically_normal().string();
+
+  // Stat before parsing, so a change during the parse is seen next time.
+  std::error_code ec;
+  auto mtime = std::filesystem::last_write_time(key, ec);
+  std::uintmax_t size = ec ? 0 : std::filesystem::file_size(key, ec);
+  const bool stat_ok = !ec;
+
+  if (stat_ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end() && it->second.mtime == mtime && it->second.size == size) {
+      if (auto cached = it->second.camera_info.lock()) {
+        camera_name = it->second.camera_name;
+        camera_info = std::move(cached);
+        return true;
+      }
+    }
+  }
+
+  // Parse without the lock, other files need not wait for this one.
+  std::string name;
+  auto info = std::make_shared<sensor_msgs::msg::CameraInfo>();
+  if (!camera_calibration_parsers::readCalibration(filename, name, *info)) {
+    return false;
+  }
+  camera_name = name;
+  camera_info = info;
+
+  if (stat_ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Drop calibrations nobody holds any more.
+    for (auto it = entries_.begin(); it != entries_.end(); ) {
+      it = it->second.camera_info.expired() ? entries_.erase(it) : std::next(it);
+    }
+    entries_[key] = Entry{mtime, size, std::move(name), camera_info};
+  }
+  return true;
+}
+
+void CalibrationCache::invalidate(const std::string & filename)
+{
+  const std::string key = std::filesystem::path(filename).lexically_normal().string();
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.erase(key);
+}
+
+}  // namespace impl
+}  // namespace camera_info_manager
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CALIBRATION_CACHE_HPP_
+#define CALIBRATION_CACHE_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "sensor_msgs/msg/camera_info.hpp"
+
+namespace camera_info_manager
+{
+namespace impl
+{
+
+/** Process-wide cache of parsed calibration files.
+ *
+ * CameraInfoManagers pointed at the same file share one immutable
+ * CameraInfo instead of each reading and parsing it. Entries are
+ * keyed by file name and revalidated against the file's modification
+ * time and size on every read, and dropped explicitly after a save.
+ *
+ * The cache only holds weak references: a calibration that no manager
+ * uses any more is dropped when the next file is parsed, so the cache
+ * does not grow with every file a long-running process ever loaded.
+ */
+class CalibrationCache
+{
+public:
+  static CalibrationCache & instance();
+
+  /** Read a calibration file through the cache.
+   *
+   * @param filename calibration file to read
+   * @param camera_name set to the camera name in the file
+   * @param camera_info set to the shared, parsed calibration
+   * @return true if the file was read, like readCalibration()
+   */
+  bool read(
+    const std::string & filename,
+    std::string & camera_name,
+    sensor_msgs::msg::CameraInfo::ConstSharedPtr & camera_info);
+
+  /** Drop the entry for a file, e.g. after writing it. */
+  void invalidate(const std::string & filename);
+
+private:
+  struct Entry
+  {
+    std::filesystem::file_time_type mtime;
+    std::uintmax_t size;
+    std::string camera_name;
+    std::weak_ptr<const sensor_msgs::msg::CameraInfo> camera_info;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace impl
+}  // namespace camera_info_manager
+
+#endif  // CALIBRATION_CACHE_HPP_
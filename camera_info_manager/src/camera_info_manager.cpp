@@ -37,16 +37,39 @@
 #include "camera_info_manager/camera_info_manager.hpp"
 
 #include <algorithm>
+#include <cctype>
+#include <cerrno>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <locale>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
 
 #include "rcpputils/env.hpp"
 #include "camera_calibration_parsers/parse.hpp"
+#include "camera_calibration_parsers/parse_bundle.hpp"
 #include "ament_index_cpp/get_package_share_directory.hpp"
 
+#include "calibration_cache.hpp"
+#include "url_template.hpp"
+
 
 /** @file
 
@@ -61,13 +84,87 @@
 namespace camera_info_manager
 {
 
-using camera_calibration_parsers::readCalibration;
 using camera_calibration_parsers::writeCalibration;
 
 /** URL to use when no other is defined. */
 const std::string
   default_camera_info_url = "file://${ROS_HOME}/camera_info/${NAME}.yaml";
 
+/** Value of the ${ROS_HOME} URL variable: $ROS_HOME if defined,
+ *  $HOME/.ros if not. */
+static std::string getRosHome()
+{
+  std::string ros_home_env = rcpputils::get_env_var("ROS_HOME");
+  if (!ros_home_env.empty()) {
+    return ros_home_env;
+  }
+  std::string home_env = rcpputils::get_env_var("HOME");
+  if (!home_env.empty()) {
+    return home_env + "/.ros";
+  }
+  return std::string();
+}
+
+/** Share directory of a package, looked up once per process.
+ *
+ * @throw ament_index_cpp::PackageNotFoundError if not found, which
+ *        is not cached.
+ */
+static std::string getPackageShareDirectory(const std::string & package)
+{
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::string> directories;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = directories.find(package);
+    if (it != directories.end()) {
+      return it->second;
+    }
+  }
+  std::string directory = ament_index_cpp::get_package_share_directory(package);
+  std::lock_guard<std::mutex> lock(mutex);
+  directories.emplace(package, directory);
+  return directory;
+}
+
+/** Split a @c bundle: URL into the bundle file name and camera.
+ *
+ * parseURL() already checked that both are present.
+ */
+static std::pair<std::string, std::string> splitBundleURL(const std::string & url)
+{
+  size_t hash = url.rfind('#');
+  size_t prefix_len = std::string("bundle://").length();
+  return {url.substr(prefix_len, hash - prefix_len), url.substr(hash + 1)};
+}
+
+/** Do two CameraInfo messages hold the same calibration?
+ *
+ * Headers are ignored, calibration files do not store them.
+ */
+static bool sameCalibration(const CameraInfo & a, const CameraInfo & b)
+{
+  return a.height == b.height && a.width == b.width &&
+    a.distortion_model == b.distortion_model && a.d == b.d &&
+    a.k == b.k && a.r == b.r && a.p == b.p &&
+    a.binning_x == b.binning_x && a.binning_y == b.binning_y &&
+    a.roi == b.roi;
+}
+
+/** Case-insensitive prefix test, without copying either string. */
+static bool startsWithNoCase(const std::string & str, const char * prefix)
+{
+  size_t i = 0;
+  for (; prefix[i] != '\0'; ++i) {
+    if (i >= str.size() ||
+      tolower(static_cast<unsigned char>(str[i])) != tolower(static_cast<unsigned char>(prefix[i])))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 /** Constructor
  *
  * @param node node, normally for the driver's streaming name
@@ -76,20 +173,24 @@ const std::string
  *           subordinate names, like "left/camera" and "right/camera".
  * @param cname default camera name
  * @param url default Uniform Resource Locator for loading and saving data.
+ * @param load_mode whether to load calibration data on first use or
+ *           right away in a background thread.
  */
 CameraInfoManager::CameraInfoManager(
   rclcpp::Node * node, const std::string & cname,
-  const std::string & url)
+  const std::string & url, LoadMode load_mode)
 : CameraInfoManager(node->get_node_base_interface(),
-    node->get_node_services_interface(), node->get_node_logging_interface(), cname, url)
+    node->get_node_services_interface(), node->get_node_logging_interface(), cname, url,
+    rmw_qos_profile_default, load_mode)
 {
 }
 
 CameraInfoManager::CameraInfoManager(
   rclcpp_lifecycle::LifecycleNode * node,
-  const std::string & cname, const std::string & url)
+  const std::string & cname, const std::string & url, LoadMode load_mode)
 : CameraInfoManager(node->get_node_base_interface(),
-    node->get_node_services_interface(), node->get_node_logging_interface(), cname, url)
+    node->get_node_services_interface(), node->get_node_logging_interface(), cname, url,
+    rmw_qos_profile_default, load_mode)
 {
 }
 
@@ -97,11 +198,13 @@ CameraInfoManager::CameraInfoManager(
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base_interface,
   rclcpp::node_interfaces::NodeServicesInterface::SharedPtr node_services_interface,
   rclcpp::node_interfaces::NodeLoggingInterface::SharedPtr node_logger_interface,
-  const std::string & cname, const std::string & url, rmw_qos_profile_t custom_qos)
+  const std::string & cname, const std::string & url, rmw_qos_profile_t custom_qos,
+  LoadMode load_mode)
 : logger_(node_logger_interface->get_logger()),
   camera_name_(cname),
   url_(url),
-  loaded_cam_info_(false)
+  loaded_cam_info_(false),
+  load_mode_(load_mode)
 {
   using namespace std::placeholders;
 
@@ -109,6 +212,56 @@ CameraInfoManager::CameraInfoManager(
   info_service_ = rclcpp::create_service<SetCameraInfo>(
     node_base_interface, node_services_interface, "~/set_camera_info",
     std::bind(&CameraInfoManager::setCameraInfoService, this, _1, _2), custom_qos, nullptr);
+
+  if (load_mode_ != LoadMode::Lazy) {
+    // load being attempted now, off the caller's thread
+    loaded_cam_info_ = true;
+    loading_ = true;
+    load_thread_ = std::thread(
+      [this, url = url_, cname = camera_name_]() {
+        // nothing can catch an exception leaving this thread, so an
+        // unknown package only fails the load
+        try {
+          loadCalibration(url, cname);
+        } catch (const std::exception & e) {
+          RCLCPP_ERROR(
+            logger_, "failed to load camera calibration from %s: %s",
+            url.c_str(), e.what());
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!std::atomic_load(&cam_info_snapshot_)) {
+          publishSnapshot();              // load failed, still done
+        }
+        loading_ = false;
+        loaded_cv_.notify_all();
+      });
+  }
+}
+
+/** Destructor
+ *
+ * Waits for the writer thread to store any pending calibration and
+ * answer its service requests.
+ */
+CameraInfoManager::~CameraInfoManager()
+{
+  stopWatching();
+#ifdef __linux__
+  if (watch_wake_fd_ >= 0) {
+    close(watch_wake_fd_);
+  }
+#endif
+  if (load_thread_.joinable()) {
+    load_thread_.join();
+  }
+  {
+    std::lock_guard<std::mutex> lock(save_mutex_);
+    stop_writer_ = true;
+  }
+  save_cv_.notify_all();
+  if (writer_.joinable()) {
+    writer_.join();
+  }
 }
 
 /** Get the current CameraInfo data.
@@ -132,7 +285,10 @@ CameraInfo CameraInfoManager::getCameraInfo(void)
     std::string cname;
     std::string url;
     {
-      std::lock_guard<std::mutex> lock(mutex_);
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!waitForBackgroundLoad(lock, false)) {
+        return CameraInfo();            // not loaded yet
+      }
       if (loaded_cam_info_) {
         return cam_info_;               // all done
       }
@@ -152,6 +308,82 @@ CameraInfo CameraInfoManager::getCameraInfo(void)
   return CameraInfo();
 }
 
+/** Get a shared snapshot of the current CameraInfo data.
+ *
+ * Meant for drivers that need CameraInfo for every frame. Once
+ * loaded, this neither locks nor copies: every update publishes a
+ * new immutable snapshot, and readers keep whichever one they got
+ * for as long as they hold it. The first call, and the first after
+ * setCameraName(), loads the data like getCameraInfo().
+ *
+ * In LoadMode::BackgroundNonBlocking, this is null until the
+ * background load completes.
+ *
+ * The snapshot header is not meaningful. Publish it with
+ * image_transport::CameraPublisher::publish(Image::UniquePtr,
+ * CameraInfo::ConstSharedPtr), which sends it with the image header.
+ */
+CameraInfo::ConstSharedPtr CameraInfoManager::getCameraInfoSnapshot(void)
+{
+  auto snapshot = std::atomic_load(&cam_info_snapshot_);
+  if (snapshot) {
+    return snapshot;
+  }
+
+  // not loaded yet: load as getCameraInfo() does, then publish the
+  // result even if the load failed
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!waitForBackgroundLoad(lock, false)) {
+        return nullptr;                 // not loaded yet
+      }
+    }
+    getCameraInfo();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // a setCameraName() since then leaves cam_info_ for the old name,
+    // which must not be published: load again
+    if (loaded_cam_info_ || !rclcpp::ok()) {
+      snapshot = std::atomic_load(&cam_info_snapshot_);
+      if (!snapshot) {
+        publishSnapshot();
+        snapshot = std::atomic_load(&cam_info_snapshot_);
+      }
+      return snapshot;
+    }
+  }
+}
+
+/** Wait for the background load started by the constructor, if any.
+ *
+ * @pre @a lock holds mutex_
+ *
+ * @param lock lock on mutex_, released while waiting
+ * @param block wait even in LoadMode::BackgroundNonBlocking
+ * @return false if the load is still in progress and the caller
+ *         must not wait for it.
+ */
+bool CameraInfoManager::waitForBackgroundLoad(
+  std::unique_lock<std::mutex> & lock, bool block)
+{
+  if (loading_ && !block && load_mode_ == LoadMode::BackgroundNonBlocking) {
+    return false;
+  }
+  loaded_cv_.wait(lock, [this] {return !loading_;});
+  return true;
+}
+
+/** Replace the CameraInfo snapshot with a copy of cam_info_.
+ *
+ * @pre mutex_ locked
+ */
+void CameraInfoManager::publishSnapshot()
+{
+  std::atomic_store(
+    &cam_info_snapshot_, CameraInfo::ConstSharedPtr(std::make_shared<CameraInfo>(cam_info_)));
+}
+
 /** Get file name corresponding to a @c package: URL.
  *
  * @param url a copy of the Uniform Resource Locator
@@ -168,7 +400,7 @@ std::string CameraInfoManager::getPackageFileName(const std::string & url)
   std::string package(url.substr(prefix_len, rest - prefix_len));
 
   // Look up the ROS package path name.
-  std::string pkgPath = ament_index_cpp::get_package_share_directory(package);
+  std::string pkgPath = getPackageShareDirectory(package);
   if (pkgPath.empty()) {                // package not found?
     RCLCPP_WARN(logger_, "unknown package: %s (ignored)", package.c_str());
     return pkgPath;
@@ -178,6 +410,30 @@ std::string CameraInfoManager::getPackageFileName(const std::string & url)
   }
 }
 
+/** Get the local file name a calibration URL refers to.
+ *
+ * @param url a copy of the Uniform Resource Locator
+ * @param cname is a copy of the camera_name_
+ * @return file name for @c file: and @c package: URLs (the default
+ *         URL if empty), "" otherwise
+ */
+std::string CameraInfoManager::getCalibrationFileName(
+  const std::string & url,
+  const std::string & cname)
+{
+  auto location = resolveLocation(url, cname);
+  switch (location->type) {
+    case URL_empty:
+      return getCalibrationFileName(default_camera_info_url, cname);
+    case URL_file:
+      return location->resolved.substr(7);
+    case URL_package:
+      return getPackageFileName(location->resolved);
+    default:
+      return std::string();
+  }
+}
+
 /** Is the current CameraInfo calibrated?
  *
  * If CameraInfo has not yet been loaded, an attempt must be made
@@ -193,7 +449,10 @@ bool CameraInfoManager::isCalibrated(void)
     std::string cname;
     std::string url;
     {
-      std::lock_guard<std::mutex> lock(mutex_);
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!waitForBackgroundLoad(lock, false)) {
+        return false;                   // not loaded yet
+      }
       if (loaded_cam_info_) {
         return cam_info_.k[0] != 0.0;
       }
@@ -227,8 +486,9 @@ bool CameraInfoManager::loadCalibration(
 {
   bool success = false;                 // return value
 
-  const std::string resURL(resolveURL(url, cname));
-  url_type_t url_type = parseURL(resURL);
+  auto location = resolveLocation(url, cname);
+  const std::string & resURL = location->resolved;
+  url_type_t url_type = location->type;
 
   if (url_type != URL_empty) {
     RCLCPP_INFO(logger_, "camera calibration URL: %s", resURL.c_str());
@@ -259,6 +519,11 @@ bool CameraInfoManager::loadCalibration(
         }
         break;
       }
+    case URL_bundle:
+      {
+        success = loadCalibrationBundle(resURL, cname);
+        break;
+      }
     default:
       {
         RCLCPP_ERROR(logger_, "Invalid camera calibration URL: %s", resURL.c_str());
@@ -277,7 +542,7 @@ bool CameraInfoManager::loadCalibration(
  * @param cname is a copy of the camera_name_
  * @return true if URL contains calibration data.
  *
- * Sets cam_info_, if successful
+ * Sets cam_info_, if successful and @a cname is still the camera name
  */
 bool CameraInfoManager::loadCalibrationFile(
   const std::string & filename,
@@ -287,9 +552,9 @@ bool CameraInfoManager::loadCalibrationFile(
 
   RCLCPP_DEBUG(logger_, "reading camera calibration from %s", filename.c_str());
   std::string cam_name;
-  CameraInfo cam_info;
+  CameraInfo::ConstSharedPtr cam_info;
 
-  if (readCalibration(filename, cam_name, cam_info)) {
+  if (impl::CalibrationCache::instance().read(filename, cam_name, cam_info)) {
     if (cname != cam_name) {
       RCLCPP_WARN(
         logger_,
@@ -300,7 +565,13 @@ bool CameraInfoManager::loadCalibrationFile(
     {
       // lock only while updating cam_info_
       std::lock_guard<std::mutex> lock(mutex_);
-      cam_info_ = cam_info;
+      // after a setCameraName() the data are for the old name, and
+      // whoever gets the CameraInfo next loads again
+      if (cname == camera_name_) {
+        cam_info_ = *cam_info;
+        // share the cached data rather than publishing another copy
+        std::atomic_store(&cam_info_snapshot_, cam_info);
+      }
     }
   } else {
     RCLCPP_WARN(logger_, "Camera calibration file %s not found", filename.c_str());
@@ -309,6 +580,50 @@ bool CameraInfoManager::loadCalibrationFile(
   return success;
 }
 
+/** Load CameraInfo calibration data from a calibration bundle.
+ *
+ * @pre mutex_ unlocked
+ *
+ * @param url resolved @c bundle: URL naming the bundle and camera
+ * @param cname is a copy of the camera_name_
+ * @return true if the bundle contains calibration data for the camera.
+ *
+ * Sets cam_info_, if successful and @a cname is still the camera name
+ */
+bool CameraInfoManager::loadCalibrationBundle(
+  const std::string & url,
+  const std::string & cname)
+{
+  auto [filename, camera] = splitBundleURL(url);
+  RCLCPP_DEBUG(
+    logger_, "reading camera calibration for %s from bundle %s",
+    camera.c_str(), filename.c_str());
+
+  std::string cam_name;
+  CameraInfo cam_info;
+  if (!camera_calibration_parsers::readCalibrationBundle(filename, camera, cam_name, cam_info)) {
+    RCLCPP_WARN(
+      logger_, "Camera calibration for %s not found in bundle %s",
+      camera.c_str(), filename.c_str());
+    return false;
+  }
+  if (cname != cam_name) {
+    RCLCPP_WARN(
+      logger_,
+      "[%s] does not match %s in bundle %s",
+      cname.c_str(), cam_name.c_str(), filename.c_str());
+  }
+  {
+    // lock only while updating cam_info_, unless renamed meanwhile
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cname == camera_name_) {
+      cam_info_ = cam_info;
+      publishSnapshot();
+    }
+  }
+  return true;
+}
+
 /** Set a new URL and load its calibration data (if any).
  *
  * If multiple threads call this method simultaneously with different
@@ -324,12 +639,15 @@ bool CameraInfoManager::loadCameraInfo(const std::string & url)
 {
   std::string cname;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitForBackgroundLoad(lock, true);
     url_ = url;
     cname = camera_name_;
     loaded_cam_info_ = true;
   }
 
+  wakeWatcher();
+
   // load using copies of the parameters, no need to hold the lock
   return loadCalibration(url, cname);
 }
@@ -346,54 +664,59 @@ std::string CameraInfoManager::resolveURL(
   const std::string & url,
   const std::string & cname)
 {
-  std::string resolved;
-  size_t rest = 0;
-
-  while (true) {
-    // find the next '$' in the URL string
-    size_t dollar = url.find('$', rest);
-
-    if (dollar >= url.length()) {
-      // no more variables left in the URL
-      resolved += url.substr(rest);
-      break;
-    }
-
-    // copy characters up to the next '$'
-    resolved += url.substr(rest, dollar - rest);
-
-    if (url.substr(dollar + 1, 1) != "{") {
-      // no '{' follows, so keep the '$'
-      resolved += "$";
-    } else if (url.substr(dollar + 1, 6) == "{NAME}") {
-      // substitute camera name
-      resolved += cname;
-      dollar += 6;
-    } else if (url.substr(dollar + 1, 10) == "{ROS_HOME}") {
-      // substitute $ROS_HOME
-      std::string ros_home;
-      std::string ros_home_env = rcpputils::get_env_var("ROS_HOME");
-      std::string home_env = rcpputils::get_env_var("HOME");
-      if (!ros_home_env.empty()) {
-        // use environment variable
-        ros_home = ros_home_env;
-      } else if (!home_env.empty()) {
-        // use "$HOME/.ros"
-        ros_home = home_env;
-        ros_home += "/.ros";
-      }
-      resolved += ros_home;
-      dollar += 10;
-    } else {
-      // not a valid substitution variable
-      RCLCPP_ERROR(logger_, "invalid URL substitution (not resolved): %s", url.c_str());
-      resolved += "$";                // keep the bogus '$'
-    }
+  return resolveLocation(url, cname)->resolved;
+}
 
-    // look for next '$'
-    rest = dollar + 1;
+/** Resolve a Uniform Resource Locator, reusing the previous result.
+ *
+ * The URL is compiled into a template and resolved only when it or
+ * the camera name differ from the last call, $ROS_HOME and $HOME
+ * are read at that time. The default URL is cached separately, so
+ * it does not displace the configured one.
+ *
+ * @param url a copy of the Uniform Resource Locator, which may
+ *            include <tt>${...}</tt> substitution variables.
+ * @param cname is a copy of the camera_name_
+ *
+ * @return the resolved URL and its type.
+ */
+std::shared_ptr<const CameraInfoManager::ResolvedLocation>
+CameraInfoManager::resolveLocation(
+  const std::string & url,
+  const std::string & cname)
+{
+  auto & cached = url == default_camera_info_url ? default_location_ : location_;
+  auto location = std::atomic_load(&cached);
+  if (location && location->url == url && location->cname == cname) {
+    return location;
   }
+  location = compileLocation(url, cname);
+  std::atomic_store(&cached, location);
+  return location;
+}
 
+/** Resolve a Uniform Resource Locator without the cache.
+ *
+ * @param url a copy of the Uniform Resource Locator, which may
+ *            include <tt>${...}</tt> substitution variables.
+ * @param cname is a copy of the camera_name_
+ *
+ * @return the resolved URL and its type.
+ */
+std::shared_ptr<const CameraInfoManager::ResolvedLocation>
+CameraInfoManager::compileLocation(
+  const std::string & url,
+  const std::string & cname)
+{
+  impl::UrlTemplate url_template(url);
+  if (url_template.hasInvalidSubstitution()) {
+    RCLCPP_ERROR(logger_, "invalid URL substitution (not resolved): %s", url.c_str());
+  }
+  auto resolved = std::make_shared<ResolvedLocation>();
+  resolved->url = url;
+  resolved->cname = cname;
+  resolved->resolved = url_template.resolve(cname, getRosHome());
+  resolved->type = parseURL(resolved->resolved);
   return resolved;
 }
 
@@ -410,25 +733,21 @@ CameraInfoManager::url_type_t CameraInfoManager::parseURL(const std::string & ur
     return URL_empty;
   }
 
-  // Easy C++14 replacement for boost::iequals from :
-  // https://stackoverflow.com/a/4119881
-  auto iequals = [](const std::string & a, const std::string & b) {
-      return std::equal(
-        a.begin(), a.end(),
-        b.begin(), b.end(),
-        [](char a, char b) {
-          return tolower(a) == tolower(b);
-        });
-    };
-
-
-  if (iequals(url.substr(0, 8), "file:///")) {
+  if (startsWithNoCase(url, "file:///")) {
     return URL_file;
   }
-  if (iequals(url.substr(0, 9), "flash:///")) {
+  if (startsWithNoCase(url, "flash:///")) {
     return URL_flash;
   }
-  if (iequals(url.substr(0, 10), "package://")) {
+  if (startsWithNoCase(url, "bundle:///")) {
+    // look for a '#' following the file name, make sure the camera
+    // after it is not empty
+    size_t hash = url.rfind('#');
+    if (hash != std::string::npos && hash > 10 && hash < url.length() - 1) {
+      return URL_bundle;
+    }
+  }
+  if (startsWithNoCase(url, "package://")) {
     // look for a '/' following the package name, make sure it is
     // there, the name is not empty, and something follows it
     size_t rest = url.find('/', 10);
@@ -457,9 +776,10 @@ CameraInfoManager::saveCalibration(
 {
   bool success = false;
 
-  const std::string resURL(resolveURL(url, cname));
+  auto location = resolveLocation(url, cname);
+  const std::string & resURL = location->resolved;
 
-  switch (parseURL(resURL)) {
+  switch (location->type) {
     case URL_empty:
       {
         // store using default file name
@@ -479,6 +799,11 @@ CameraInfoManager::saveCalibration(
         }
         break;
       }
+    case URL_bundle:
+      {
+        success = saveCalibrationBundle(new_info, resURL, cname);
+        break;
+      }
     default:
       {
         // invalid URL, save to default location
@@ -491,10 +816,92 @@ CameraInfoManager::saveCalibration(
   return success;
 }
 
+/** Compare two files byte for byte.
+ *
+ * @return true if both files exist and have the same content.
+ */
+static bool sameFileContents(
+  const std::filesystem::path & a,
+  const std::filesystem::path & b)
+{
+  std::error_code ec;
+  auto size = std::filesystem::file_size(a, ec);
+  if (ec || size != std::filesystem::file_size(b, ec) || ec) {
+    return false;
+  }
+  std::ifstream fa(a, std::ios::binary);
+  std::ifstream fb(b, std::ios::binary);
+  return fa && fb && std::equal(
+    std::istreambuf_iterator<char>(fa), std::istreambuf_iterator<char>(),
+    std::istreambuf_iterator<char>(fb));
+}
+
+/** Create a uniquely named, empty file next to @a filepath.
+ *
+ * The name keeps the extension, camera_calibration_parsers picks the
+ * format from it, and takes the permissions of an existing @a filepath.
+ *
+ * @return path of the new file, or empty if it cannot be created.
+ */
+static std::filesystem::path createTempFile(const std::filesystem::path & filepath)
+{
+  const std::string extension = filepath.extension().string();
+  std::string name = (filepath.parent_path() /
+    ("." + filepath.stem().string() + ".XXXXXX")).string();
+#ifndef _WIN32
+  name += extension;
+  int fd = mkstemps(&name[0], static_cast<int>(extension.size()));
+  if (fd < 0) {
+    return std::filesystem::path();
+  }
+  // mkstemps() makes the file private
+  struct stat st;
+  fchmod(fd, ::stat(filepath.c_str(), &st) == 0 ? (st.st_mode & 0777) : 0644);
+  ::close(fd);
+#else
+  if (_mktemp_s(&name[0], name.size() + 1) != 0) {
+    return std::filesystem::path();
+  }
+  name += extension;
+  std::ofstream touch(name, std::ios::binary);
+#endif
+  return name;
+}
+
+/** Save CameraInfo calibration data to a calibration bundle.
+ *
+ * @pre mutex_ unlocked
+ *
+ * Rewrites only the record of the camera named in the URL, the
+ * bundle itself is replaced atomically.
+ *
+ * @param new_info contains CameraInfo to save
+ * @param url resolved @c bundle: URL naming the bundle and camera
+ * @param cname is a copy of the camera_name_
+ * @return true, if successful
+ */
+bool
+CameraInfoManager::saveCalibrationBundle(
+  const CameraInfo & new_info,
+  const std::string & url,
+  const std::string & cname)
+{
+  auto [filename, camera] = splitBundleURL(url);
+  RCLCPP_INFO(
+    logger_, "writing calibration data for %s to bundle %s",
+    camera.c_str(), filename.c_str());
+  return camera_calibration_parsers::writeCalibrationBundle(filename, camera, cname, new_info);
+}
+
 /** Save CameraInfo calibration data to a file.
  *
  * @pre mutex_ unlocked
  *
+ * The data are written to a temporary file in the same directory,
+ * which then replaces @a filename, so readers never see a partial
+ * file. If the file already holds the same content, it is left
+ * untouched.
+ *
  * @param new_info contains CameraInfo to save
  * @param filename is local file to store data
  * @param cname is a copy of the camera_name_
@@ -511,38 +918,72 @@ CameraInfoManager::saveCalibrationFile(
   std::filesystem::path filepath(filename);
   std::filesystem::path parent = filepath.parent_path();
 
-  if (!std::filesystem::exists(parent)) {
-    if (!std::filesystem::create_directories(parent)) {
+  std::error_code ec;
+  if (!std::filesystem::exists(parent, ec)) {
+    if (!std::filesystem::create_directories(parent, ec)) {
       RCLCPP_ERROR(logger_, "unable to create path directory [%s]", parent.string().c_str());
       return false;
     }
   }
 
+  // A unique name, so concurrent saves never write the same file.
+  std::filesystem::path temppath = createTempFile(filepath);
+  if (temppath.empty()) {
+    RCLCPP_ERROR(
+      logger_, "unable to create a temporary file for %s: %s", filename.c_str(),
+      strerror(errno));
+    return false;
+  }
+
   // Directory exists. Permissions might still be bad.
-  // Currently, writeCalibration() always returns true no matter what
-  // (ros-pkg ticket #5010).
-  return writeCalibration(filename, cname, new_info);
+  if (!writeCalibration(temppath.string(), cname, new_info) ||
+    !std::filesystem::exists(temppath, ec))
+  {
+    RCLCPP_ERROR(logger_, "unable to write calibration file %s", temppath.string().c_str());
+    std::filesystem::remove(temppath, ec);
+    return false;
+  }
+
+  if (sameFileContents(temppath, filepath)) {
+    RCLCPP_DEBUG(logger_, "calibration in %s is unchanged", filename.c_str());
+    std::filesystem::remove(temppath, ec);
+    return true;
+  }
+
+  std::filesystem::rename(temppath, filepath, ec);
+  // the file may change within the modification time resolution
+  impl::CalibrationCache::instance().invalidate(filename);
+  if (ec) {
+    RCLCPP_ERROR(
+      logger_, "unable to replace %s: %s", filename.c_str(), ec.message().c_str());
+    std::filesystem::remove(temppath, ec);
+    return false;
+  }
+  return true;
 }
 
 /** Callback for SetCameraInfo request.
  *
- * Always updates cam_info_ class variable, even if save fails.
+ * Always updates cam_info_ class variable, even if save fails. The
+ * save itself is queued for the writer thread, which sends the
+ * response once it completes.
  *
+ * @param request_header identifies the request to respond to
  * @param req SetCameraInfo request message
- * @param rsp SetCameraInfo response message
- * @return true if message handled
  */
 void
 CameraInfoManager::setCameraInfoService(
-  const std::shared_ptr<SetCameraInfo::Request> req,
-  std::shared_ptr<SetCameraInfo::Response> rsp)
+  const std::shared_ptr<rmw_request_id_t> request_header,
+  const std::shared_ptr<SetCameraInfo::Request> req)
 {
   // copies of class variables needed for saving calibration
   std::string url_copy;
   std::string cname;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitForBackgroundLoad(lock, true);
     cam_info_ = req->camera_info;
+    publishSnapshot();
     url_copy = url_;
     cname = camera_name_;
     loaded_cam_info_ = true;
@@ -550,14 +991,326 @@ CameraInfoManager::setCameraInfoService(
 
   if (!rclcpp::ok()) {
     RCLCPP_ERROR(logger_, "set_camera_info service called, but driver not running.");
-    rsp->status_message = "Camera driver not running.";
-    rsp->success = false;
+    SetCameraInfo::Response rsp;
+    rsp.status_message = "Camera driver not running.";
+    rsp.success = false;
+    info_service_->send_response(*request_header, rsp);
     return;
   }
 
-  rsp->success = saveCalibration(req->camera_info, url_copy, cname);
-  if (!rsp->success) {
-    rsp->status_message = "Error storing camera calibration.";
+  {
+    std::lock_guard<std::mutex> lock(save_mutex_);
+    if (!pending_save_) {
+      pending_save_.emplace();
+    }
+    // A newer calibration supersedes one not yet written, but every
+    // caller still gets a response.
+    pending_save_->camera_info = req->camera_info;
+    pending_save_->url = url_copy;
+    pending_save_->cname = cname;
+    pending_save_->requests.push_back(request_header);
+    if (!writer_.joinable()) {
+      writer_ = std::thread(&CameraInfoManager::writerThread, this);
+    }
+  }
+  save_cv_.notify_one();
+}
+
+/** Writer thread: stores pending calibrations until stopped.
+ *
+ * Drains any pending save before exiting.
+ */
+void
+CameraInfoManager::writerThread()
+{
+  std::unique_lock<std::mutex> lock(save_mutex_);
+  while (true) {
+    save_cv_.wait(lock, [this] {return pending_save_ || stop_writer_;});
+    if (!pending_save_) {
+      return;
+    }
+    PendingSave save = std::move(*pending_save_);
+    pending_save_.reset();
+    SaveCallback callback = save_callback_;
+    lock.unlock();
+
+    SetCameraInfo::Response rsp;
+    // nothing can catch an exception leaving this thread, so e.g. an
+    // unknown package only fails the save, and a failed response or
+    // callback is only logged
+    try {
+      rsp.success = saveCalibration(save.camera_info, save.url, save.cname);
+    } catch (const std::exception & e) {
+      RCLCPP_ERROR(logger_, "failed to save camera calibration: %s", e.what());
+      rsp.success = false;
+    }
+    if (!rsp.success) {
+      rsp.status_message = "Error storing camera calibration.";
+    }
+    for (const auto & request_header : save.requests) {
+      // fails e.g. when draining saves after rclcpp::shutdown()
+      try {
+        info_service_->send_response(*request_header, rsp);
+      } catch (const std::exception & e) {
+        RCLCPP_ERROR(logger_, "failed to send set_camera_info response: %s", e.what());
+      }
+    }
+    if (callback) {
+      try {
+        callback(rsp.success, rsp.status_message);
+      } catch (const std::exception & e) {
+        RCLCPP_ERROR(logger_, "save callback failed: %s", e.what());
+      }
+    }
+
+    lock.lock();
+  }
+}
+
+/** Set the save completion callback
+ *
+ * @param callback called from the writer thread after each save of
+ *        a calibration received by the set_camera_info service.
+ */
+void CameraInfoManager::setSaveCallback(const SaveCallback & callback)
+{
+  std::lock_guard<std::mutex> lock(save_mutex_);
+  save_callback_ = callback;
+}
+
+/** Set the calibration callback
+ *
+ * @param callback called from the watcher thread with the new data
+ *        each time a change of the watched calibration file is
+ *        loaded.
+ */
+void CameraInfoManager::setCalibrationCallback(const CalibrationCallback & callback)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  calibration_callback_ = callback;
+}
+
+/** Start watching the calibration file for changes.
+ *
+ * Only supported on Linux, using inotify. The parent directory is
+ * watched rather than the file itself, so the file may be replaced
+ * by rename, as editors and saveCalibrationFile() do, or created
+ * later.
+ *
+ * @param debounce time without further changes before reloading
+ * @return true if watching, false if not supported or inotify
+ *         could not be set up.
+ */
+bool CameraInfoManager::startWatching(std::chrono::milliseconds debounce)
+{
+#ifdef __linux__
+  if (watch_thread_.joinable()) {
+    return true;
+  }
+  if (watch_wake_fd_ < 0) {
+    // kept open until destruction, so that wakeWatcher() never sees
+    // it change under a running watcher
+    int wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd < 0) {
+      RCLCPP_ERROR(logger_, "unable to watch calibration file: %s", strerror(errno));
+      return false;
+    }
+    watch_wake_fd_ = wake_fd;
+  }
+  watch_debounce_ = debounce;
+  stop_watching_ = false;
+  watch_thread_ = std::thread(&CameraInfoManager::watchThread, this);
+  return true;
+#else
+  (void) debounce;
+  RCLCPP_WARN(logger_, "calibration file watching is only supported on Linux");
+  return false;
+#endif
+}
+
+/** Stop watching the calibration file, if watching. */
+void CameraInfoManager::stopWatching()
+{
+  if (!watch_thread_.joinable()) {
+    return;
+  }
+  stop_watching_ = true;
+  wakeWatcher();
+  watch_thread_.join();
+}
+
+/** Make the watcher thread check for stop and resolve the URL again. */
+void CameraInfoManager::wakeWatcher()
+{
+#ifdef __linux__
+  int wake_fd = watch_wake_fd_;
+  if (wake_fd >= 0) {
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd, &one, sizeof(one));
+    (void) written;
+  }
+#endif
+}
+
+#ifdef __linux__
+/** Read all pending inotify events.
+ *
+ * @return true if any of them concerns @a name.
+ */
+static bool drainInotifyEvents(int fd, const std::string & name)
+{
+  bool matched = false;
+  alignas(struct inotify_event) char buffer[4096];
+  while (true) {
+    ssize_t length = read(fd, buffer, sizeof(buffer));
+    if (length <= 0) {
+      return matched;
+    }
+    for (char * ptr = buffer; ptr < buffer + length; ) {
+      auto event = reinterpret_cast<const struct inotify_event *>(ptr);
+      if (event->len > 0 && name == event->name) {
+        matched = true;
+      }
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+}
+#endif
+
+/** Watcher thread: reloads the calibration file when it changes.
+ *
+ * Resolves the current URL again whenever woken by wakeWatcher().
+ */
+void CameraInfoManager::watchThread()
+{
+#ifdef __linux__
+  int inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd < 0) {
+    RCLCPP_ERROR(logger_, "unable to watch calibration file: %s", strerror(errno));
+    return;
+  }
+
+  const int wake_fd = watch_wake_fd_;
+  int watch = -1;
+  std::filesystem::path filepath;
+  bool rewatch = true;
+  while (!stop_watching_) {
+    if (rewatch) {
+      rewatch = false;
+      if (watch >= 0) {
+        inotify_rm_watch(inotify_fd, watch);
+        watch = -1;
+      }
+      std::string url;
+      std::string cname;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        url = url_;
+        cname = camera_name_;
+      }
+      try {
+        filepath = getCalibrationFileName(url, cname);
+      } catch (const std::exception & e) {
+        // e.g. an unknown package, there is nothing to watch
+        RCLCPP_WARN(logger_, "unable to watch %s: %s", url.c_str(), e.what());
+        filepath.clear();
+      }
+      if (!filepath.empty()) {
+        watch = inotify_add_watch(
+          inotify_fd, filepath.parent_path().c_str(),
+          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watch < 0) {
+          RCLCPP_WARN(
+            logger_, "unable to watch %s: %s", filepath.parent_path().c_str(), strerror(errno));
+        } else {
+          RCLCPP_DEBUG(logger_, "watching calibration file %s", filepath.c_str());
+        }
+      }
+    }
+
+    struct pollfd fds[2] = {{inotify_fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      RCLCPP_ERROR(logger_, "calibration file watch failed: %s", strerror(errno));
+      break;
+    }
+    if (fds[1].revents & POLLIN) {
+      uint64_t count;
+      ssize_t bytes = read(wake_fd, &count, sizeof(count));
+      (void) bytes;
+      rewatch = true;
+      continue;
+    }
+    if (!drainInotifyEvents(inotify_fd, filepath.filename().string())) {
+      continue;
+    }
+
+    // debounce: wait until the directory has been quiet for a while
+    while (!stop_watching_) {
+      struct pollfd quiet = {inotify_fd, POLLIN, 0};
+      if (poll(&quiet, 1, static_cast<int>(watch_debounce_.count())) <= 0) {
+        break;
+      }
+      drainInotifyEvents(inotify_fd, filepath.filename().string());
+    }
+    if (!stop_watching_) {
+      reloadWatchedFile(filepath.string());
+    }
+  }
+
+  close(inotify_fd);
+#endif
+}
+
+/** Load a changed calibration file and swap it in.
+ *
+ * @pre mutex_ unlocked
+ *
+ * Does nothing if the file cannot be read or holds the current data.
+ *
+ * @param filename containing CameraInfo to read
+ */
+void CameraInfoManager::reloadWatchedFile(const std::string & filename)
+{
+  std::string cname;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cname = camera_name_;
+  }
+
+  std::string cam_name;
+  CameraInfo::ConstSharedPtr cam_info;
+  if (!impl::CalibrationCache::instance().read(filename, cam_name, cam_info)) {
+    RCLCPP_WARN(logger_, "unable to reload camera calibration from %s", filename.c_str());
+    return;
+  }
+  if (cname != cam_name) {
+    RCLCPP_WARN(
+      logger_,
+      "[%s] does not match %s in file %s",
+      cname.c_str(), cam_name.c_str(), filename.c_str());
+  }
+
+  CalibrationCallback callback;
+  CameraInfo::ConstSharedPtr snapshot;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitForBackgroundLoad(lock, true);
+    if (loaded_cam_info_ && sameCalibration(*cam_info, cam_info_)) {
+      return;                           // e.g. our own save
+    }
+    cam_info_ = *cam_info;
+    loaded_cam_info_ = true;
+    std::atomic_store(&cam_info_snapshot_, cam_info);
+    snapshot = cam_info;
+    callback = calibration_callback_;
+  }
+
+  RCLCPP_INFO(logger_, "reloaded camera calibration from %s", filename.c_str());
+  if (callback) {
+    callback(snapshot);
   }
 }
 
@@ -589,10 +1342,13 @@ bool CameraInfoManager::setCameraName(const std::string & cname)
   // name might cause the existing URL to resolve somewhere else,
   // force @c cam_info_ to be reloaded before being used again.
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitForBackgroundLoad(lock, true);
     camera_name_ = cname;
     loaded_cam_info_ = false;
+    std::atomic_store(&cam_info_snapshot_, CameraInfo::ConstSharedPtr());
   }
+  wakeWatcher();
 
   return true;
 }
@@ -607,10 +1363,12 @@ bool CameraInfoManager::setCameraName(const std::string & cname)
  */
 bool CameraInfoManager::setCameraInfo(const CameraInfo & camera_info)
 {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  waitForBackgroundLoad(lock, true);
 
   cam_info_ = camera_info;
   loaded_cam_info_ = true;
+  publishSnapshot();
 
   return true;
 }
@@ -630,7 +1388,8 @@ bool CameraInfoManager::validateURL(const std::string & url)
     cname = camera_name_;
   }  // release the lock
 
-  url_type_t url_type = parseURL(resolveURL(url, cname));
+  // usually not the configured URL, which must stay cached
+  url_type_t url_type = compileLocation(url, cname)->type;
   return url_type < URL_invalid;
 }
 }  // namespace camera_info_manager
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef URL_TEMPLATE_HPP_
+#define URL_TEMPLATE_HPP_
+
+#include <string>
+#include <vector>
+
+namespace camera_info_manager
+{
+namespace impl
+{
+
+/** A calibration URL compiled into literal and variable tokens.
+ *
+ * Compiling applies the CameraInfoManager substitution rules once:
+ * @c ${NAME} and @c ${ROS_HOME} become variables, any other
+ * <tt>${...}</tt> is kept literally and flagged, and a '$' not
+ * followed by '{' is kept. Resolving then only concatenates.
+ */
+class UrlTemplate
+{
+public:
+  explicit UrlTemplate(const std::string & url)
+  {
+    size_t rest = 0;
+    while (rest < url.size()) {
+      size_t dollar = url.find('$', rest);
+      if (dollar == std::string::npos) {
+        appendLiteral(url, rest, url.size() - rest);
+        break;
+      }
+      appendLiteral(url, rest, dollar - rest);
+      if (url.compare(dollar + 1, 6, "{NAME}") == 0) {
+        tokens_.push_back({Kind::Name, std::string()});
+        rest = dollar + 7;
+      } else if (url.compare(dollar + 1, 10, "{ROS_HOME}") == 0) {
+        tokens_.push_back({Kind::RosHome, std::string()});
+        rest = dollar + 11;
+      } else {
+        if (url.compare(dollar + 1, 1, "{") == 0) {
+          invalid_substitution_ = true;
+        }
+        appendLiteral(url, dollar, 1);
+        rest = dollar + 1;
+      }
+    }
+  }
+
+  /** True if the URL has a <tt>${...}</tt> that is not a known variable. */
+  bool hasInvalidSubstitution() const
+  {
+    return invalid_substitution_;
+  }
+
+  std::string resolve(const std::string & cname, const std::string & ros_home) const
+  {
+    std::string resolved;
+    resolved.reserve(literal_size_ + cname.size() + ros_home.size());
+    for (const auto & token : tokens_) {
+      switch (token.kind) {
+        case Kind::Literal:
+          resolved += token.text;
+          break;
+        case Kind::Name:
+          resolved += cname;
+          break;
+        case Kind::RosHome:
+          resolved += ros_home;
+          break;
+      }
+    }
+    return resolved;
+  }
+
+private:
+  enum class Kind
+  {
+    Literal,
+    Name,
+    RosHome,
+  };
+
+  struct Token
+  {
+    Kind kind;
+    std::string text;
+  };
+
+  void appendLiteral(const std::string & url, size_t pos, size_t count)
+  {
+    if (count == 0) {
+      return;
+    }
+    if (tokens_.empty() || tokens_.back().kind != Kind::Literal) {
+      tokens_.push_back({Kind::Literal, std::string()});
+    }
+    tokens_.back().text.append(url, pos, count);
+    literal_size_ += count;
+  }
+
+  std::vector<Token> tokens_;
+  size_t literal_size_ = 0;
+  bool invalid_substitution_ = false;
+};
+
+}  // namespace impl
+}  // namespace camera_info_manager
+
+#endif  // URL_TEMPLATE_HPP_
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2024, Open Source Robotics Foundation, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_calibration_parsers/parse.hpp"
+#include "camera_calibration_parsers/parse_bundle.hpp"
+#include "camera_info_manager/camera_info_manager.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/distortion_models.hpp"
+
+using camera_info_manager::CameraInfoManager;
+using sensor_msgs::msg::CameraInfo;
+using sensor_msgs::srv::SetCameraInfo;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+CameraInfo makeCalibration(uint32_t width)
+{
+  CameraInfo cam_info;
+  cam_info.width = width;
+  cam_info.height = 480;
+  cam_info.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
+  cam_info.d = {-0.36, 0.18, 0.0, 0.0, 0.0};
+  cam_info.k = {430.0, 0, 320.0, 0, 430.0, 240.0, 0, 0, 1};
+  cam_info.r = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+  cam_info.p = {430.0, 0, 320.0, 0, 0, 430.0, 240.0, 0, 0, 0, 1, 0};
+  return cam_info;
+}
+
+}  // namespace
+
+class CameraInfoManagerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = std::filesystem::temp_directory_path() /
+      ("camera_info_manager_test_" + std::to_string(std::random_device()()));
+    std::filesystem::create_directories(dir_);
+    filename_ = (dir_ / "camera.yaml").string();
+    url_ = "file://" + filename_;
+
+    node_ = rclcpp::Node::make_shared("camera_info_manager_test");
+    executor_.add_node(node_);
+    client_ = node_->create_client<SetCameraInfo>("~/set_camera_info");
+  }
+
+  void TearDown() override
+  {
+    executor_.remove_node(node_);
+    std::error_code ec;
+    std::filesystem::remove_all(dir_, ec);
+  }
+
+  rclcpp::Client<SetCameraInfo>::SharedFuture setCameraInfo(const CameraInfo & cam_info)
+  {
+    EXPECT_TRUE(client_->wait_for_service(5s));
+    auto request = std::make_shared<SetCameraInfo::Request>();
+    request->camera_info = cam_info;
+    return client_->async_send_request(request).future.share();
+  }
+
+  bool spinUntilComplete(const rclcpp::Client<SetCameraInfo>::SharedFuture & future)
+  {
+    return executor_.spin_until_future_complete(future, 5s) ==
+      rclcpp::FutureReturnCode::SUCCESS;
+  }
+
+  uint32_t storedWidth()
+  {
+    std::string camera_name;
+    CameraInfo cam_info;
+    if (!camera_calibration_parsers::readCalibration(filename_, camera_name, cam_info)) {
+      return 0;
+    }
+    return cam_info.width;
+  }
+
+  std::filesystem::path dir_;
+  std::string filename_;
+  std::string url_;
+  rclcpp::Node::SharedPtr node_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  rclcpp::Client<SetCameraInfo>::SharedPtr client_;
+};
+
+TEST_F(CameraInfoManagerTest, set_camera_info_responds_once_stored)
+{
+  CameraInfoManager manager(node_.get(), "camera", url_);
+
+  auto future = setCameraInfo(makeCalibration(640));
+  ASSERT_TRUE(spinUntilComplete(future));
+  EXPECT_TRUE(future.get()->success);
+  EXPECT_EQ(manager.getCameraInfo().width, 640u);
+  // The writer thread answers only after the file is written.
+  EXPECT_EQ(storedWidth(), 640u);
+}
+
+TEST_F(CameraInfoManagerTest, set_camera_info_reports_failed_save)
+{
+  CameraInfoManager manager(node_.get(), "camera", "file://" + filename_ + "/camera.yaml");
+  // A file where a directory is needed makes the save fail.
+  ASSERT_TRUE(
+    camera_calibration_parsers::writeCalibration(filename_, "camera", makeCalibration(1)));
+
+  auto future = setCameraInfo(makeCalibration(640));
+  ASSERT_TRUE(spinUntilComplete(future));
+  EXPECT_FALSE(future.get()->success);
+  EXPECT_FALSE(future.get()->status_message.empty());
+  // The calibration is in use even though it was not stored.
+  EXPECT_EQ(manager.getCameraInfo().width, 640u);
+}
+
+TEST_F(CameraInfoManagerTest, saves_while_writing_are_coalesced)
+{
+  std::mutex mutex;
+  std::condition_variable cv;
+  int saves = 0;
+  bool release = false;
+
+  CameraInfoManager manager(node_.get(), "camera", url_);
+  // Hold the writer thread after its first save, so the following
+  // requests queue up behind it.
+  manager.setSaveCallback(
+    [&](bool, const std::string &) {
+      std::unique_lock<std::mutex> lock(mutex);
+      ++saves;
+      cv.notify_all();
+      cv.wait(lock, [&] {return release;});
+    });
+
+  auto first = setCameraInfo(makeCalibration(100));
+  ASSERT_TRUE(spinUntilComplete(first));
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(cv.wait_for(lock, 5s, [&] {return saves == 1;}));
+  }
+
+  std::vector<rclcpp::Client<SetCameraInfo>::SharedFuture> queued;
+  for (uint32_t width : {200u, 300u, 400u}) {
+    queued.push_back(setCameraInfo(makeCalibration(width)));
+  }
+  // Each request is applied right away, only the save waits.
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (manager.getCameraInfo().width != 400u && std::chrono::steady_clock::now() < deadline) {
+    executor_.spin_some(10ms);
+  }
+  ASSERT_EQ(manager.getCameraInfo().width, 400u);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    release = true;
+  }
+  cv.notify_all();
+
+  for (const auto & future : queued) {
+    ASSERT_TRUE(spinUntilComplete(future));
+    EXPECT_TRUE(future.get()->success);
+  }
+  {
+    // The responses are sent before the save callback runs.
+    std::unique_lock<std::mutex> lock(mutex);
+    EXPECT_TRUE(cv.wait_for(lock, 5s, [&] {return saves >= 2;}));
+    EXPECT_EQ(saves, 2);
+  }
+  EXPECT_EQ(storedWidth(), 400u);
+}
+
+TEST_F(CameraInfoManagerTest, concurrent_saves_of_one_file)
+{
+  auto other_node = rclcpp::Node::make_shared("camera_info_manager_test_other");
+  executor_.add_node(other_node);
+  auto other_client = other_node->create_client<SetCameraInfo>("~/set_camera_info");
+  ASSERT_TRUE(other_client->wait_for_service(5s));
+
+  // Two managers of the same file save at the same time.
+  CameraInfoManager manager(node_.get(), "camera", url_);
+  CameraInfoManager other(other_node.get(), "camera", url_);
+  std::vector<rclcpp::Client<SetCameraInfo>::SharedFuture> futures;
+  for (uint32_t i = 0; i < 20; ++i) {
+    futures.push_back(setCameraInfo(makeCalibration(100 + i)));
+    auto request = std::make_shared<SetCameraInfo::Request>();
+    request->camera_info = makeCalibration(200 + i);
+    futures.push_back(other_client->async_send_request(request).future.share());
+  }
+  for (const auto & future : futures) {
+    ASSERT_TRUE(spinUntilComplete(future));
+    EXPECT_TRUE(future.get()->success);
+  }
+  executor_.remove_node(other_node);
+
+  // The file holds one complete calibration, and no temporary file is left.
+  const uint32_t width = storedWidth();
+  EXPECT_TRUE(width == 119u || width == 219u) << width;
+  for (const auto & entry : std::filesystem::directory_iterator(dir_)) {
+    EXPECT_EQ(entry.path().string(), filename_);
+  }
+}
+
+TEST_F(CameraInfoManagerTest, throwing_save_callback)
+{
+  CameraInfoManager manager(node_.get(), "camera", url_);
+  manager.setSaveCallback(
+    [](bool, const std::string &) {throw std::runtime_error("callback failed");});
+
+  // The writer thread outlives the exception and serves the next request.
+  for (uint32_t width : {100u, 200u}) {
+    auto future = setCameraInfo(makeCalibration(width));
+    ASSERT_TRUE(spinUntilComplete(future));
+    EXPECT_TRUE(future.get()->success);
+    EXPECT_EQ(storedWidth(), width);
+  }
+}
+
+TEST_F(CameraInfoManagerTest, snapshot_follows_camera_name)
+{
+  for (auto [name, width] : {std::make_pair("left", 100u), std::make_pair("right", 200u)}) {
+    ASSERT_TRUE(
+      camera_calibration_parsers::writeCalibration(
+        (dir_ / (std::string(name) + ".yaml")).string(), name, makeCalibration(width)));
+  }
+  CameraInfoManager manager(node_.get(), "left", "file://" + dir_.string() + "/${NAME}.yaml");
+
+  // Renames race with the loads started by snapshot readers.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; ++i) {
+    readers.emplace_back(
+      [&] {
+        while (!done) {
+          manager.getCameraInfoSnapshot();
+        }
+      });
+  }
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_TRUE(manager.setCameraName(i % 2 ? "left" : "right"));
+    std::this_thread::sleep_for(std::chrono::microseconds(i % 7 * 50));
+  }
+  done = true;
+  for (auto & reader : readers) {
+    reader.join();
+  }
+
+  // The last rename was to "left".
+  EXPECT_EQ(manager.getCameraInfoSnapshot()->width, 100u);
+}
+
+TEST_F(CameraInfoManagerTest, bundle_load_and_save)
+{
+  const std::string bundle = (dir_ / "rig.calib").string();
+  ASSERT_TRUE(
+    camera_calibration_parsers::writeCalibrationBundle(
+      bundle, {{"left", makeCalibration(100)}, {"right", makeCalibration(200)}}));
+
+  CameraInfoManager manager(node_.get(), "left", "bundle://" + bundle + "#left");
+  EXPECT_EQ(manager.getCameraInfo().width, 100u);
+
+  auto future = setCameraInfo(makeCalibration(150));
+  ASSERT_TRUE(spinUntilComplete(future));
+  EXPECT_TRUE(future.get()->success);
+
+  // Only the manager's camera is replaced.
+  std::map<std::string, CameraInfo> cam_infos;
+  ASSERT_TRUE(camera_calibration_parsers::readCalibrationBundle(bundle, cam_infos));
+  EXPECT_EQ(cam_infos["left"].width, 150u);
+  EXPECT_EQ(cam_infos["right"].width, 200u);
+}
+
+TEST_F(CameraInfoManagerTest, background_load_of_unknown_package)
+{
+  CameraInfoManager manager(
+    node_.get(), "camera", "package://no_such_package/camera.yaml",
+    CameraInfoManager::LoadMode::Background);
+
+  // The failed load still completes, uncalibrated.
+  EXPECT_FALSE(manager.isCalibrated());
+  auto snapshot = manager.getCameraInfoSnapshot();
+  ASSERT_TRUE(snapshot);
+  EXPECT_EQ(snapshot->k[0], 0.0);
+}
+
+TEST_F(CameraInfoManagerTest, reloads_changed_file)
+{
+  ASSERT_TRUE(
+    camera_calibration_parsers::writeCalibration(filename_, "camera", makeCalibration(100)));
+  CameraInfoManager manager(node_.get(), "camera", url_);
+  EXPECT_EQ(manager.getCameraInfo().width, 100u);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<uint32_t> reloaded;
+  manager.setCalibrationCallback(
+    [&](const CameraInfo::ConstSharedPtr & info) {
+      std::lock_guard<std::mutex> lock(mutex);
+      reloaded.push_back(info->width);
+      cv.notify_all();
+    });
+  if (!manager.startWatching(20ms)) {
+    GTEST_SKIP() << "calibration file watching is not supported here";
+  }
+
+  // The watch is set up by the watcher thread, so keep writing until it
+  // notices. Rewriting the same data does not reload it again.
+  bool noticed = false;
+  for (int attempt = 0; attempt < 25 && !noticed; ++attempt) {
+    ASSERT_TRUE(
+      camera_calibration_parsers::writeCalibration(filename_, "camera", makeCalibration(200)));
+    std::unique_lock<std::mutex> lock(mutex);
+    noticed = cv.wait_for(lock, 200ms, [&] {return !reloaded.empty();});
+  }
+  ASSERT_TRUE(noticed);
+  EXPECT_EQ(manager.getCameraInfo().width, 200u);
+  EXPECT_EQ(manager.getCameraInfoSnapshot()->width, 200u);
+
+  // Our own saves are not reloaded, even though the stored file has no
+  // header.
+  CameraInfo saved = makeCalibration(300);
+  saved.header.frame_id = "camera";
+  auto future = setCameraInfo(saved);
+  ASSERT_TRUE(spinUntilComplete(future));
+  EXPECT_TRUE(future.get()->success);
+  std::this_thread::sleep_for(300ms);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(reloaded, std::vector<uint32_t>{200u});
+  }
+  EXPECT_EQ(manager.getCameraInfo().header.frame_id, "camera");
+}
+
+TEST_F(CameraInfoManagerTest, watch_unknown_package)
+{
+  CameraInfoManager manager(node_.get(), "camera", "package://no_such_package/camera.yaml");
+  // Nothing to watch, but the watcher thread survives until stopped.
+  if (manager.startWatching(20ms)) {
+    std::this_thread::sleep_for(50ms);
+    manager.stopWatching();
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return ret;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, Open Source Robotics Foundation, Inc.
+ * Copyright (c) 2024, Open Source Robotics Foundation, Inc.
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -10,7 +10,7 @@
  *     * Redistributions in binary form must reproduce the above copyright
  *       notice, this list of conditions and the following disclaimer in the
  *       documentation and/or other materials provided with the distribution.
- *     * Neither the name of the Willow Garage, Inc. nor the names of its
+ *     * Neither the name of the copyright holder nor the names of its
  *       contributors may be used to endorse or promote products derived from
  *       this software without specific prior written permission.
  *
@@ -27,30 +27,44 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef SPLIT_HPP_
-#define SPLIT_HPP_
+#include <gtest/gtest.h>
 
-#include <regex>
 #include <string>
-#include <vector>
 
-namespace camera_info_manager
-{
-namespace impl
+#include "url_template.hpp"
+
+using camera_info_manager::impl::UrlTemplate;
+
+TEST(UrlTemplate, literal)
 {
+  UrlTemplate url("file:///tmp/camera.yaml");
+  EXPECT_FALSE(url.hasInvalidSubstitution());
+  EXPECT_EQ(url.resolve("camera", "/home/ros"), "file:///tmp/camera.yaml");
+  EXPECT_EQ(UrlTemplate("").resolve("camera", "/home/ros"), "");
+}
 
-inline std::vector<std::string>
-split(const std::string & input, const std::string & regex)
+TEST(UrlTemplate, variables)
 {
-  std::regex re(regex);
-  // the -1 will cause this to return the stuff between the matches, see the submatch argument:
-  //   http://en.cppreference.com/w/cpp/regex/regex_token_iterator/regex_token_iterator
-  std::sregex_token_iterator first(input.begin(), input.end(), re, -1);
-  std::sregex_token_iterator last;
-  return {first, last};  // vector will copy from first to last
+  UrlTemplate url("file://${ROS_HOME}/camera_info/${NAME}.yaml");
+  EXPECT_FALSE(url.hasInvalidSubstitution());
+  EXPECT_EQ(url.resolve("left", "/home/ros"), "file:///home/ros/camera_info/left.yaml");
+  // Compiled once, resolved for any name.
+  EXPECT_EQ(url.resolve("right", "/root"), "file:///root/camera_info/right.yaml");
+  EXPECT_EQ(UrlTemplate("${NAME}${NAME}").resolve("a", ""), "aa");
 }
 
-}  // namespace impl
-}  // namespace camera_info_manager
+TEST(UrlTemplate, unknown_variables)
+{
+  UrlTemplate url("file:///tmp/${FOO}/${NAME}.yaml");
+  EXPECT_TRUE(url.hasInvalidSubstitution());
+  EXPECT_EQ(url.resolve("camera", "/home/ros"), "file:///tmp/${FOO}/camera.yaml");
+}
 
-#endif  // SPLIT_HPP_
+TEST(UrlTemplate, plain_dollars)
+{
+  UrlTemplate url("file:///tmp/$NAME/cost$.yaml$");
+  EXPECT_FALSE(url.hasInvalidSubstitution());
+  EXPECT_EQ(url.resolve("camera", "/home/ros"), "file:///tmp/$NAME/cost$.yaml$");
+  // An unterminated variable is flagged as well.
+  EXPECT_TRUE(UrlTemplate("file:///tmp/${NAME").hasInvalidSubstitution());
+}
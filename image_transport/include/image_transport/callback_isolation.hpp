@@ -0,0 +1,86 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef IMAGE_TRANSPORT__CALLBACK_ISOLATION_HPP_
+#define IMAGE_TRANSPORT__CALLBACK_ISOLATION_HPP_
+
+#include <vector>
+
+namespace image_transport
+{
+
+/**
+ * \brief Controls where the callbacks of an image subscription are executed.
+ *
+ * By default image subscriptions use the callback group passed in
+ * rclcpp::SubscriptionOptions and are run by whatever executor spins the node. Image
+ * decoding can be expensive, so this allows a subscription to own a dedicated callback
+ * group and, optionally, a private executor thread, keeping image work away from timers,
+ * services and control-loop callbacks of the same node.
+ */
+struct CallbackIsolation
+{
+  /**
+   * \brief Create a mutually exclusive callback group owned by the subscription.
+   *
+   * Any callback group set in the subscription options is replaced. Without a dedicated
+   * executor thread the group is still added to the executor spinning the node.
+   */
+  bool dedicated_callback_group = false;
+
+  /**
+   * \brief Spin the dedicated callback group on a private single-threaded executor.
+   *
+   * Implies dedicated_callback_group. The thread is stopped when the subscription is
+   * shut down.
+   */
+  bool dedicated_executor_thread = false;
+
+  /**
+   * \brief CPUs the private executor thread may run on. Empty leaves the affinity alone.
+   *
+   * Only supported on Linux.
+   */
+  std::vector<int> cpu_affinity;
+
+  /**
+   * \brief SCHED_FIFO priority for the private executor thread. 0 leaves the default policy.
+   *
+   * Only supported on Linux, and usually requires CAP_SYS_NICE or a matching rtprio limit.
+   */
+  int priority = 0;
+
+  bool enabled() const
+  {
+    return dedicated_callback_group || dedicated_executor_thread;
+  }
+};
+
+}  // namespace image_transport
+
+#endif  // IMAGE_TRANSPORT__CALLBACK_ISOLATION_HPP_
@@ -125,6 +125,18 @@ public:
     sensor_msgs::msg::Image::UniquePtr image,
     sensor_msgs::msg::CameraInfo::UniquePtr info) const;
 
+  /*!
+   * \brief Publish an (image, info) pair on the topics associated with this CameraPublisher.
+   *
+   * For a shared, immutable info such as CameraInfoManager::getCameraInfoSnapshot(). The
+   * info is sent with the image's header, so the only copy made is the message that is
+   * published.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  void publish(
+    sensor_msgs::msg::Image::UniquePtr image,
+    const sensor_msgs::msg::CameraInfo::ConstSharedPtr & info) const;
+
   /*!
    * \brief Publish an (image, info) pair with given timestamp on the topics associated with
    * this CameraPublisher.
@@ -39,6 +39,7 @@
 #include "sensor_msgs/msg/camera_info.hpp"
 #include "sensor_msgs/msg/image.hpp"
 
+#include "image_transport/callback_isolation.hpp"
 #include "image_transport/visibility_control.hpp"
 
 namespace image_transport
@@ -74,7 +75,9 @@ public:
     const std::string & base_topic,
     const Callback & callback,
     const std::string & transport,
-    rmw_qos_profile_t = rmw_qos_profile_default);
+    rmw_qos_profile_t = rmw_qos_profile_default,
+    rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions(),
+    const CallbackIsolation & isolation = CallbackIsolation());
 
   IMAGE_TRANSPORT_PUBLIC
   CameraSubscriber(
@@ -82,7 +85,9 @@ public:
     const std::string & base_topic,
     const Callback & callback,
     const std::string & transport,
-    rmw_qos_profile_t = rmw_qos_profile_default);
+    rmw_qos_profile_t = rmw_qos_profile_default,
+    rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions(),
+    const CallbackIsolation & isolation = CallbackIsolation());
 
   /**
    * \brief Get the base topic (on which the raw image is published).
@@ -131,7 +136,9 @@ private:
     const std::string & base_topic,
     const Callback & callback,
     const std::string & transport,
-    rmw_qos_profile_t custom_qos);
+    rmw_qos_profile_t custom_qos,
+    rclcpp::SubscriptionOptions options,
+    const CallbackIsolation & isolation);
 
   struct Impl;
   std::shared_ptr<Impl> impl_;
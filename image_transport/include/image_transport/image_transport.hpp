@@ -36,6 +36,7 @@
 
 #include "rclcpp/node.hpp"
 
+#include "image_transport/callback_isolation.hpp"
 #include "image_transport/camera_publisher.hpp"
 #include "image_transport/camera_subscriber.hpp"
 #include "image_transport/publisher.hpp"
@@ -67,6 +68,9 @@ Publisher<NodeType> create_publisher(
 
 /**
  * \brief Subscribe to an image topic, free function version.
+ *
+ * \param isolation Optionally give the subscription its own callback group and executor
+ * thread, see CallbackIsolation.
  */
 template<class NodeType = rclcpp::Node>
 IMAGE_TRANSPORT_PUBLIC
@@ -76,7 +80,8 @@ Subscriber<NodeType> create_subscription(
   const typename Subscriber<NodeType>::Callback & callback,
   const std::string & transport,
   rmw_qos_profile_t custom_qos = rmw_qos_profile_default,
-  rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions());
+  rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions(),
+  const CallbackIsolation & isolation = CallbackIsolation());
 
 template<class NodeType = rclcpp::Node>
 IMAGE_TRANSPORT_PUBLIC
@@ -86,7 +91,8 @@ Subscriber<NodeType> create_subscription(
   const typename Subscriber<NodeType>::Callback & callback,
   const std::string & transport,
   rmw_qos_profile_t custom_qos = rmw_qos_profile_default,
-  rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions());
+  rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions(),
+  const CallbackIsolation & isolation = CallbackIsolation());
 
 /*!
  * \brief Advertise a camera, free function version.
@@ -109,6 +115,9 @@ CameraPublisher<NodeType> create_camera_publisher(
 
 /*!
  * \brief Subscribe to a camera, free function version.
+ *
+ * The image and camera info subscriptions share the callback group from \a options, or
+ * the dedicated one requested by \a isolation.
  */
 template<class NodeType = rclcpp::Node>
 IMAGE_TRANSPORT_PUBLIC
@@ -117,7 +126,9 @@ CameraSubscriber<NodeType> create_camera_subscription(
   const std::string & base_topic,
   const typename CameraSubscriber<NodeType>::Callback & callback,
   const std::string & transport,
-  rmw_qos_profile_t custom_qos = rmw_qos_profile_default);
+  rmw_qos_profile_t custom_qos = rmw_qos_profile_default,
+  rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions(),
+  const CallbackIsolation & isolation = CallbackIsolation());
 
 template<class NodeType = rclcpp::Node>
 IMAGE_TRANSPORT_PUBLIC
@@ -126,7 +137,9 @@ CameraSubscriber<NodeType> create_camera_subscription(
   const std::string & base_topic,
   const typename CameraSubscriber<NodeType>::Callback & callback,
   const std::string & transport,
-  rmw_qos_profile_t custom_qos = rmw_qos_profile_default);
+  rmw_qos_profile_t custom_qos = rmw_qos_profile_default,
+  rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions(),
+  const CallbackIsolation & isolation = CallbackIsolation());
 
 template<class NodeType = rclcpp::Node>
 IMAGE_TRANSPORT_PUBLIC
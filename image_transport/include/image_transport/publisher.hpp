@@ -62,6 +62,16 @@ namespace image_transport
  * Once all copies of a specific Publisher go out of scope, any subscriber callbacks
  * associated with that handle will stop being called. Once all Publisher for a
  * given base topic go out of scope the topic (and all subtopics) will be unadvertised.
+ *
+ * Plugins listed in the "<base_topic>.lazy_pub_plugins" parameter (using the same names
+ * as "<base_topic>.enable_pub_plugins", e.g. "image_transport/compressed") start
+ * dormant: they are neither instantiated nor advertised until a subscriber appears on
+ * "<base_topic>/<transport>", and are torn down again once they had no subscribers for
+ * "<base_topic>.lazy_pub_plugins_grace_period" seconds (default 5). A plugin advertising
+ * another subtopic needs it in "<base_topic>.<transport>.lazy_topic". Dormant topics do
+ * not show up in the graph, so tools listing the available transports of a topic will
+ * not see them, and getNumSubscribers() does not count subscribers waiting for them.
+ * The raw transport is never dormant.
  */
 template<class NodeType = rclcpp::Node>
 class Publisher
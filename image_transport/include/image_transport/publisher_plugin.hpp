@@ -103,6 +103,17 @@ public:
    */
   virtual std::string getTopic() const = 0;
 
+  /**
+   * \brief Return the communication topic this plugin advertises for a given base topic.
+   *
+   * Defaults to \<base topic\>/\<transport name\>. Unlike getTopic(), this can be asked
+   * before advertise().
+   */
+  virtual std::string getTopicToAdvertise(const std::string & base_topic) const
+  {
+    return base_topic + "/" + getTransportName();
+  }
+
   /**
    * \brief Publish an image using the transport associated with this PublisherPlugin.
    */
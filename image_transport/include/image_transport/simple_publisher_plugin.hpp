@@ -182,7 +182,7 @@ protected:
    *
    * Defaults to \<base topic\>/\<transport name\>.
    */
-  virtual std::string getTopicToAdvertise(const std::string & base_topic) const
+  std::string getTopicToAdvertise(const std::string & base_topic) const override
   {
     return base_topic + "/" + PublisherPlugin<NodeType>::getTransportName();
   }
@@ -0,0 +1,268 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef IMAGE_TRANSPORT__STATIC_PUBLISHER_HPP_
+#define IMAGE_TRANSPORT__STATIC_PUBLISHER_HPP_
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "rclcpp/expand_topic_or_service_name.hpp"
+#include "rclcpp/logging.hpp"
+#include "rclcpp/node.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "sensor_msgs/msg/image.hpp"
+
+namespace image_transport
+{
+
+/**
+ * \brief Transport policy for StaticPublisher publishing unaltered images on the base
+ * topic, like RawPublisher.
+ *
+ * A transport policy is a class template over the node type providing:
+ * - a static constexpr bool kSupportsUniquePtr;
+ * - advertise(node, base_topic, qos, options), creating the transport-specific topic;
+ * - getNumSubscribers(), getTopic() and shutdown();
+ * - publish(const sensor_msgs::msg::Image &), and publish(sensor_msgs::msg::Image::UniquePtr)
+ *   if kSupportsUniquePtr is true.
+ *
+ * Policies are called directly, without virtual dispatch, so they should be cheap to
+ * inline. To interoperate with regular Subscribers a policy must use the same topic and
+ * message type as the matching plugin.
+ */
+template<class NodeType = rclcpp::Node>
+class RawTransport
+{
+public:
+  static constexpr bool kSupportsUniquePtr = true;
+
+  void advertise(
+    const std::shared_ptr<NodeType> & node, const std::string & base_topic,
+    const rclcpp::QoS & qos, const rclcpp::PublisherOptions & options)
+  {
+    publisher_ = node->template create_publisher<sensor_msgs::msg::Image>(
+      base_topic, qos, options);
+  }
+
+  size_t getNumSubscribers() const
+  {
+    return publisher_ ? publisher_->get_subscription_count() : 0;
+  }
+
+  std::string getTopic() const
+  {
+    return publisher_ ? publisher_->get_topic_name() : std::string();
+  }
+
+  void publish(const sensor_msgs::msg::Image & message) const
+  {
+    publisher_->publish(message);
+  }
+
+  void publish(sensor_msgs::msg::Image::UniquePtr message) const
+  {
+    publisher_->publish(std::move(message));
+  }
+
+  void shutdown()
+  {
+    publisher_.reset();
+  }
+
+private:
+  typename rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr publisher_;
+};
+
+/**
+ * \brief Publisher over a set of transports fixed at compile time.
+ *
+ * StaticPublisher is a lightweight alternative to Publisher for latency sensitive code.
+ * Instead of loading plugins and dispatching every call through PublisherPlugin's
+ * virtual interface, it holds one instance of each transport policy by value and
+ * publishes through them with fold expressions the compiler can inline. The topics it
+ * advertises are the ones the corresponding plugins would, so regular Subscribers
+ * connect to it as usual. For example:
+\verbatim
+image_transport::StaticPublisher<rclcpp::Node, image_transport::RawTransport> pub(
+  node, "camera/image");
+pub.publish(std::move(image));
+\endverbatim
+ *
+ * Unlike Publisher it does not read the enable_pub_plugins parameter.
+ */
+template<class NodeType, template<class> class ... Transports>
+class StaticPublisher
+{
+  static_assert(sizeof...(Transports) > 0, "StaticPublisher needs at least one transport");
+
+public:
+  StaticPublisher() = default;
+
+  StaticPublisher(
+    std::shared_ptr<NodeType> node,
+    const std::string & base_topic,
+    rmw_qos_profile_t custom_qos = rmw_qos_profile_default,
+    rclcpp::PublisherOptions options = rclcpp::PublisherOptions())
+  : logger_(node->get_logger())
+  {
+    // Resolve the name explicitly, as Publisher does, so derived topics remap properly.
+    base_topic_ = rclcpp::expand_topic_or_service_name(
+      base_topic, node->get_name(), node->get_namespace());
+    auto qos = rclcpp::QoS(rclcpp::QoSInitialization::from_rmw(custom_qos), custom_qos);
+    std::apply(
+      [&](auto &... transport) {(transport.advertise(node, base_topic_, qos, options), ...);},
+      transports_);
+    valid_ = true;
+  }
+
+  /**
+   * \brief Returns the total number of subscribers to all transports.
+   */
+  size_t getNumSubscribers() const
+  {
+    if (!valid_) {
+      return 0;
+    }
+    return std::apply(
+      [](const auto &... transport) {return (transport.getNumSubscribers() + ...);},
+      transports_);
+  }
+
+  /**
+   * \brief Returns the base topic of this StaticPublisher.
+   */
+  std::string getTopic() const
+  {
+    return base_topic_;
+  }
+
+  /**
+   * \brief Publish an image on every transport with subscribers.
+   */
+  void publish(const sensor_msgs::msg::Image & message) const
+  {
+    if (!checkValid()) {
+      return;
+    }
+    std::apply(
+      [&message](const auto &... transport) {
+        ((transport.getNumSubscribers() > 0 ? transport.publish(message) : void()), ...);
+      },
+      transports_);
+  }
+
+  /**
+   * \brief Publish an image on every transport with subscribers.
+   */
+  void publish(const sensor_msgs::msg::Image::ConstSharedPtr & message) const
+  {
+    publish(*message);
+  }
+
+  /**
+   * \brief Publish an image on every transport with subscribers.
+   *
+   * As in Publisher, the first subscribed transport supporting it takes ownership of the
+   * message; the others publish from it beforehand.
+   */
+  void publish(sensor_msgs::msg::Image::UniquePtr message) const
+  {
+    if (!checkValid()) {
+      return;
+    }
+    publishUniquePtr(std::move(message), std::index_sequence_for<Transports<NodeType>...>());
+  }
+
+  /**
+   * \brief Shutdown the advertisements of all transports.
+   */
+  void shutdown()
+  {
+    if (valid_) {
+      valid_ = false;
+      std::apply([](auto &... transport) {(transport.shutdown(), ...);}, transports_);
+    }
+  }
+
+  operator void *() const
+  {
+    return valid_ ? reinterpret_cast<void *>(1) : reinterpret_cast<void *>(0);
+  }
+
+private:
+  using TransportTuple = std::tuple<Transports<NodeType>...>;
+
+  bool checkValid() const
+  {
+    if (!valid_) {
+      RCLCPP_FATAL(logger_, "Call to publish() on an invalid image_transport::StaticPublisher");
+    }
+    return valid_;
+  }
+
+  template<size_t ... I>
+  void publishUniquePtr(
+    sensor_msgs::msg::Image::UniquePtr message, std::index_sequence<I...>) const
+  {
+    constexpr size_t kNoOwner = sizeof...(I);
+    const std::array<bool, sizeof...(I)> subscribed{
+      (std::get<I>(transports_).getNumSubscribers() > 0)...};
+
+    size_t owner = kNoOwner;
+    ((owner == kNoOwner && subscribed[I] &&
+    std::tuple_element_t<I, TransportTuple>::kSupportsUniquePtr ? (void)(owner = I) : void()),
+    ...);
+
+    ((I != owner && subscribed[I] ? std::get<I>(transports_).publish(*message) : void()), ...);
+    ((I == owner ? publishOwned(std::get<I>(transports_), std::move(message)) : void()), ...);
+  }
+
+  template<class Transport>
+  static void publishOwned(const Transport & transport, sensor_msgs::msg::Image::UniquePtr message)
+  {
+    if constexpr (Transport::kSupportsUniquePtr) {
+      transport.publish(std::move(message));
+    } else {
+      transport.publish(*message);
+    }
+  }
+
+  rclcpp::Logger logger_ = rclcpp::get_logger("image_transport");
+  std::string base_topic_;
+  TransportTuple transports_;
+  bool valid_ = false;
+};
+
+}  // namespace image_transport
+
+#endif  // IMAGE_TRANSPORT__STATIC_PUBLISHER_HPP_
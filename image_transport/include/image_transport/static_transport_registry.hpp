@@ -0,0 +1,183 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef IMAGE_TRANSPORT__STATIC_TRANSPORT_REGISTRY_HPP_
+#define IMAGE_TRANSPORT__STATIC_TRANSPORT_REGISTRY_HPP_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rclcpp/node.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+
+#include "image_transport/loader_fwds.hpp"
+#include "image_transport/visibility_control.hpp"
+
+namespace image_transport
+{
+
+/**
+ * \brief Registry of transport plugins linked directly into the process.
+ *
+ * Publisher and Subscriber look up transports here before falling back to pluginlib, so
+ * a statically registered transport is created without parsing plugin manifests or
+ * calling dlopen(). Transports are registered under their pluginlib lookup names (for
+ * example "image_transport/raw_pub") with the IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER
+ * and IMAGE_TRANSPORT_REGISTER_STATIC_SUBSCRIBER macros, usually from a source file of
+ * the executable or library that links the transport in.
+ *
+ * The raw transport is registered by libimage_transport itself when it is built with the
+ * IMAGE_TRANSPORT_BUILTIN_RAW CMake option.
+ *
+ * The default pluginlib loaders, and with them the plugin manifests, are only read once
+ * something needs a transport that is not registered here. That is the case for a
+ * Publisher whose "enable_pub_plugins" parameter is left at its default (every declared
+ * transport), for the "auto" transport's remote lookup, and for getDeclaredTransports()
+ * and getLoadableTransports().
+ */
+template<class NodeType = rclcpp::Node>
+class StaticTransportRegistry
+{
+public:
+  using PublisherFactory = std::function<std::shared_ptr<PublisherPlugin<NodeType>>()>;
+  using SubscriberFactory = std::function<std::shared_ptr<SubscriberPlugin<NodeType>>()>;
+
+  /**
+   * \brief Returns the process-wide registry for \a NodeType.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  static StaticTransportRegistry & instance();
+
+  IMAGE_TRANSPORT_PUBLIC
+  void registerPublisher(const std::string & lookup_name, PublisherFactory factory);
+
+  IMAGE_TRANSPORT_PUBLIC
+  void registerSubscriber(const std::string & lookup_name, SubscriberFactory factory);
+
+  /**
+   * \brief Create the publisher registered as \a lookup_name, or return nullptr if
+   * there is none.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  std::shared_ptr<PublisherPlugin<NodeType>> createPublisher(const std::string & lookup_name) const;
+
+  /**
+   * \brief Create the subscriber registered as \a lookup_name, or return nullptr if
+   * there is none.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  std::shared_ptr<SubscriberPlugin<NodeType>> createSubscriber(
+    const std::string & lookup_name) const;
+
+  IMAGE_TRANSPORT_PUBLIC
+  bool hasPublisher(const std::string & lookup_name) const;
+
+  IMAGE_TRANSPORT_PUBLIC
+  bool hasSubscriber(const std::string & lookup_name) const;
+
+  /**
+   * \brief Returns the lookup names of all registered publishers, sorted.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  std::vector<std::string> getPublisherLookupNames() const;
+
+  /**
+   * \brief Returns the lookup names of all registered subscribers, sorted.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  std::vector<std::string> getSubscriberLookupNames() const;
+
+private:
+  StaticTransportRegistry() = default;
+
+  mutable std::mutex mutex_;
+  std::map<std::string, PublisherFactory> publishers_;
+  std::map<std::string, SubscriberFactory> subscribers_;
+};
+
+/**
+ * \brief Registers a publisher factory on construction. Used by
+ * IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER.
+ */
+template<class NodeType, class PluginType>
+struct StaticPublisherRegistrar
+{
+  explicit StaticPublisherRegistrar(const std::string & lookup_name)
+  {
+    StaticTransportRegistry<NodeType>::instance().registerPublisher(
+      lookup_name, []() {return std::make_shared<PluginType>();});
+  }
+};
+
+/**
+ * \brief Registers a subscriber factory on construction. Used by
+ * IMAGE_TRANSPORT_REGISTER_STATIC_SUBSCRIBER.
+ */
+template<class NodeType, class PluginType>
+struct StaticSubscriberRegistrar
+{
+  explicit StaticSubscriberRegistrar(const std::string & lookup_name)
+  {
+    StaticTransportRegistry<NodeType>::instance().registerSubscriber(
+      lookup_name, []() {return std::make_shared<PluginType>();});
+  }
+};
+
+}  // namespace image_transport
+
+#define IMAGE_TRANSPORT_STATIC_REGISTRY_CONCAT_IMPL(a, b) a ## b
+#define IMAGE_TRANSPORT_STATIC_REGISTRY_CONCAT(a, b) \
+  IMAGE_TRANSPORT_STATIC_REGISTRY_CONCAT_IMPL(a, b)
+
+/**
+ * \brief Statically register publisher plugin \a PluginType for \a NodeType under
+ * \a lookup_name, e.g.
+ * IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(rclcpp::Node, MyPublisher, "my_pkg/my_pub").
+ *
+ * Must be used at namespace scope in a translation unit that is linked into the process;
+ * objects from static libraries are dropped unless something else references them.
+ */
+#define IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(NodeType, PluginType, lookup_name) \
+  static const ::image_transport::StaticPublisherRegistrar<NodeType, PluginType> \
+  IMAGE_TRANSPORT_STATIC_REGISTRY_CONCAT( \
+    image_transport_static_publisher_registrar_, __COUNTER__)(lookup_name);
+
+/**
+ * \brief Statically register subscriber plugin \a PluginType for \a NodeType under
+ * \a lookup_name. See IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER.
+ */
+#define IMAGE_TRANSPORT_REGISTER_STATIC_SUBSCRIBER(NodeType, PluginType, lookup_name) \
+  static const ::image_transport::StaticSubscriberRegistrar<NodeType, PluginType> \
+  IMAGE_TRANSPORT_STATIC_REGISTRY_CONCAT( \
+    image_transport_static_subscriber_registrar_, __COUNTER__)(lookup_name);
+
+#endif  // IMAGE_TRANSPORT__STATIC_TRANSPORT_REGISTRY_HPP_
@@ -37,8 +37,10 @@
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "sensor_msgs/msg/image.hpp"
 
+#include "image_transport/callback_isolation.hpp"
 #include "image_transport/exception.hpp"
 #include "image_transport/loader_fwds.hpp"
+#include "image_transport/subscriber_statistics.hpp"
 #include "image_transport/visibility_control.hpp"
 
 namespace image_transport
@@ -58,6 +60,12 @@ namespace image_transport
  * Once all copies of a specific Subscriber go out of scope, the subscription callback
  * associated with that handle will stop being called. Once all Subscriber for a given
  * topic go out of scope the topic will be unsubscribed.
+ *
+ * Passing "auto" as the transport lets the Subscriber choose one from the graph. It uses
+ * "raw" while the base topic is advertised by a Publisher in the same process, and the
+ * transport named by the "<base_topic>.auto_remote_transport" parameter (default
+ * "compressed") while some publisher offers it. Otherwise it falls back to "raw". The
+ * choice is re-evaluated once a second and the subscription is switched when it changes.
  */
 template<class NodeType = rclcpp::Node>
 class Subscriber
@@ -76,7 +84,8 @@ public:
     SubLoaderPtr<NodeType> loader,
     const std::string & transport,
     rmw_qos_profile_t custom_qos = rmw_qos_profile_default,
-    rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions());
+    rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions(),
+    const CallbackIsolation & isolation = CallbackIsolation());
 
   IMAGE_TRANSPORT_PUBLIC
   Subscriber(
@@ -86,7 +95,8 @@ public:
     SubLoaderPtr<NodeType> loader,
     const std::string & transport,
     rmw_qos_profile_t custom_qos = rmw_qos_profile_default,
-    rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions());
+    rclcpp::SubscriptionOptions options = rclcpp::SubscriptionOptions(),
+    const CallbackIsolation & isolation = CallbackIsolation());
 
   /**
    * \brief Returns the base image topic.
@@ -109,6 +119,36 @@ public:
   IMAGE_TRANSPORT_PUBLIC
   std::string getTransport() const;
 
+  /**
+   * \brief Start keeping statistics on the images delivered to the callback.
+   *
+   * Records message age, callback duration, inter-arrival jitter and, when
+   * options.expected_rate is set, an estimate of dropped images. Restarts the statistics
+   * if they were already enabled. While disabled, the overhead is a single atomic load
+   * per image.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  void enableStatistics(
+    const SubscriberStatisticsOptions & options = SubscriberStatisticsOptions());
+
+  /**
+   * \brief Stop keeping statistics, and publishing them if a topic was configured.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  void disableStatistics();
+
+  /**
+   * \brief Returns the statistics accumulated since they were enabled or last reset.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  SubscriberStatistics getStatistics() const;
+
+  /**
+   * \brief Clear the accumulated statistics.
+   */
+  IMAGE_TRANSPORT_PUBLIC
+  void resetStatistics();
+
   /**
    * \brief Unsubscribe the callback associated with this Subscriber.
    */
@@ -130,7 +170,8 @@ private:
     const Callback & callback,
     const std::string & transport,
     rmw_qos_profile_t custom_qos,
-    rclcpp::SubscriptionOptions options);
+    rclcpp::SubscriptionOptions options,
+    const CallbackIsolation & isolation);
 
   struct Impl;
   std::shared_ptr<Impl> impl_;
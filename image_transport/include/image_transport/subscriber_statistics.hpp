@@ -0,0 +1,140 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef IMAGE_TRANSPORT__SUBSCRIBER_STATISTICS_HPP_
+#define IMAGE_TRANSPORT__SUBSCRIBER_STATISTICS_HPP_
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace image_transport
+{
+
+/**
+ * \brief Settings for Subscriber::enableStatistics().
+ */
+struct SubscriberStatisticsOptions
+{
+  /**
+   * \brief Nominal publishing rate in Hz, used to estimate drops from gaps between
+   * consecutive header stamps. 0 disables drop estimation.
+   */
+  double expected_rate = 0.0;
+
+  /**
+   * \brief Topic on which to periodically publish statistics_msgs/MetricsMessage.
+   * Empty disables publishing; the statistics are then only available through
+   * Subscriber::getStatistics().
+   */
+  std::string topic;
+
+  /**
+   * \brief Period between two publications on \a topic.
+   */
+  std::chrono::milliseconds publish_period{1000};
+};
+
+/**
+ * \brief Running minimum, maximum, mean and standard deviation of a series of
+ * durations, in seconds.
+ */
+struct StatisticsSummary
+{
+  uint64_t count = 0;
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  double mean = 0.0;
+  /// Sum of squared differences from the mean, see stddev().
+  double m2 = 0.0;
+
+  void add(double value)
+  {
+    // Welford's online algorithm, numerically stable without keeping the samples.
+    ++count;
+    double delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (value - mean);
+    min = value < min ? value : min;
+    max = value > max ? value : max;
+  }
+
+  double stddev() const
+  {
+    return count > 1 ? std::sqrt(m2 / static_cast<double>(count - 1)) : 0.0;
+  }
+};
+
+/**
+ * \brief Snapshot of the statistics kept by a Subscriber.
+ *
+ * All durations are in seconds. The message age is the receive time, taken from the
+ * node clock, minus header.stamp, so it includes transport, decoding and executor
+ * latency but not the user callback.
+ */
+struct SubscriberStatistics
+{
+  /// Number of buckets in age_histogram.
+  static constexpr size_t kAgeHistogramBuckets = 32;
+
+  /// Number of images delivered to the user callback.
+  uint64_t received = 0;
+
+  /// Number of images estimated missing from gaps between consecutive header stamps.
+  uint64_t estimated_drops = 0;
+
+  /**
+   * \brief Log2 histogram of message age. Bucket 0 counts ages below 2 microseconds
+   * (including negative ages caused by clock skew), bucket i counts ages in
+   * [2^i, 2^(i+1)) microseconds and the last bucket everything above.
+   */
+  std::array<uint64_t, kAgeHistogramBuckets> age_histogram{};
+
+  StatisticsSummary age;
+  StatisticsSummary callback_duration;
+  StatisticsSummary inter_arrival;
+
+  /// Inter-arrival jitter, the standard deviation of the time between two images.
+  double jitter() const {return inter_arrival.stddev();}
+
+  /// Fraction of the expected images that were not received, 0 if unknown.
+  double estimatedDropRate() const
+  {
+    uint64_t expected = received + estimated_drops;
+    return expected > 0 ? static_cast<double>(estimated_drops) / static_cast<double>(expected) :
+           0.0;
+  }
+};
+
+}  // namespace image_transport
+
+#endif  // IMAGE_TRANSPORT__SUBSCRIBER_STATISTICS_HPP_
@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Open Source Robotics Foundation, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef IMAGE_TRANSPORT__TESTING__ALLOCATION_COUNTER_HPP_
+#define IMAGE_TRANSPORT__TESTING__ALLOCATION_COUNTER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace image_transport
+{
+namespace testing
+{
+
+/**
+ * \brief Number of heap allocations made by the process so far.
+ *
+ * Only counted in executables that use IMAGE_TRANSPORT_TESTING_COUNT_ALLOCATIONS().
+ */
+inline std::atomic<uint64_t> & allocationCounter()
+{
+  static std::atomic<uint64_t> counter{0};
+  return counter;
+}
+
+/**
+ * \brief True in executables that use IMAGE_TRANSPORT_TESTING_COUNT_ALLOCATIONS().
+ */
+inline std::atomic<bool> & allocationCountingEnabled()
+{
+  static std::atomic<bool> enabled{false};
+  return enabled;
+}
+
+}  // namespace testing
+}  // namespace image_transport
+
+/**
+ * \brief Count heap allocations in allocationCounter().
+ *
+ * Replaces the global operator new and delete, so use it at namespace scope in exactly one
+ * translation unit of a test or benchmark executable. This header only needs the standard
+ * library, so benchmarks of packages that do not otherwise use image_transport can share it.
+ */
+#define IMAGE_TRANSPORT_TESTING_COUNT_ALLOCATIONS() \
+  namespace \
+  { \
+  [[maybe_unused]] const bool image_transport_testing_counting = \
+    (image_transport::testing::allocationCountingEnabled() = true); \
+  } \
+  void * operator new(std::size_t size) \
+  { \
+    image_transport::testing::allocationCounter().fetch_add(1, std::memory_order_relaxed); \
+    if (void * ptr = std::malloc(size ? size : 1)) { \
+      return ptr; \
+    } \
+    throw std::bad_alloc(); \
+  } \
+  void * operator new[](std::size_t size) \
+  { \
+    return ::operator new(size); \
+  } \
+  void operator delete(void * ptr) noexcept \
+  { \
+    std::free(ptr); \
+  } \
+  void operator delete[](void * ptr) noexcept \
+  { \
+    std::free(ptr); \
+  } \
+  void operator delete(void * ptr, std::size_t) noexcept \
+  { \
+    std::free(ptr); \
+  } \
+  void operator delete[](void * ptr, std::size_t) noexcept \
+  { \
+    std::free(ptr); \
+  }
+
+#endif  // IMAGE_TRANSPORT__TESTING__ALLOCATION_COUNTER_HPP_
@@ -0,0 +1,441 @@
+// Copyright (c) 2024 Open Source Robotics Foundation, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef IMAGE_TRANSPORT__TESTING__CONFORMANCE_HPP_
+#define IMAGE_TRANSPORT__TESTING__CONFORMANCE_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "pluginlib/class_loader.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/image_encodings.hpp"
+#include "sensor_msgs/msg/image.hpp"
+
+#include "image_transport/image_transport.hpp"
+#include "image_transport/loader_fwds.hpp"
+#include "image_transport/publisher_plugin.hpp"
+#include "image_transport/static_transport_registry.hpp"
+#include "image_transport/testing/allocation_counter.hpp"
+
+namespace image_transport
+{
+namespace testing
+{
+
+struct CorpusImage
+{
+  std::string name;
+  sensor_msgs::msg::Image image;
+};
+
+/**
+ * \brief The standard synthetic corpus: smooth, flat, high-frequency and noisy content in
+ * the common encodings, so lossless and lossy transports can be compared on the same input.
+ *
+ * The content is deterministic, a given size always produces the same bytes.
+ */
+inline std::vector<CorpusImage> standardCorpus(uint32_t width = 640, uint32_t height = 480)
+{
+  auto make = [width, height](const std::string & encoding) {
+      sensor_msgs::msg::Image image;
+      image.header.frame_id = "conformance";
+      image.width = width;
+      image.height = height;
+      image.encoding = encoding;
+      image.step = width * sensor_msgs::image_encodings::numChannels(encoding) *
+        (sensor_msgs::image_encodings::bitDepth(encoding) / 8);
+      image.data.resize(static_cast<size_t>(image.step) * height);
+      return image;
+    };
+
+  std::vector<CorpusImage> corpus;
+
+  auto gradient = make(sensor_msgs::image_encodings::RGB8);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      uint8_t * pixel = &gradient.data[y * gradient.step + x * 3];
+      pixel[0] = static_cast<uint8_t>(x * 255 / std::max(width - 1, 1u));
+      pixel[1] = static_cast<uint8_t>(y * 255 / std::max(height - 1, 1u));
+      pixel[2] = static_cast<uint8_t>((x + y) & 0xff);
+    }
+  }
+  corpus.push_back({"gradient_rgb8", std::move(gradient)});
+
+  auto flat = make(sensor_msgs::image_encodings::BGR8);
+  std::fill(flat.data.begin(), flat.data.end(), uint8_t{0x80});
+  corpus.push_back({"flat_bgr8", std::move(flat)});
+
+  auto checkerboard = make(sensor_msgs::image_encodings::MONO8);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      checkerboard.data[y * checkerboard.step + x] = ((x / 8 + y / 8) % 2) ? 0xff : 0x00;
+    }
+  }
+  corpus.push_back({"checkerboard_mono8", std::move(checkerboard)});
+
+  auto noise = make(sensor_msgs::image_encodings::RGB8);
+  uint32_t state = 0x12345678u;
+  for (auto & byte : noise.data) {
+    // Numerical Recipes LCG, enough to defeat entropy coding without pulling in <random>.
+    state = state * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>(state >> 24);
+  }
+  corpus.push_back({"noise_rgb8", std::move(noise)});
+
+  auto depth = make(sensor_msgs::image_encodings::MONO16);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      uint16_t value = static_cast<uint16_t>(500 + x * 4 + y);
+      std::memcpy(&depth.data[y * depth.step + x * 2], &value, sizeof(value));
+    }
+  }
+  corpus.push_back({"ramp_mono16", std::move(depth)});
+
+  return corpus;
+}
+
+struct ConformanceOptions
+{
+  /// Transport under test, as given to create_subscription(), e.g. "raw" or "compressed".
+  std::string transport = "raw";
+  /// Frames timed per corpus image.
+  size_t frames = 30;
+  /// Untimed frames per corpus image, also used to measure the encoded size.
+  size_t warmup_frames = 3;
+  /// How long to wait for discovery and for each frame.
+  std::chrono::milliseconds timeout{2000};
+  uint32_t width = 640;
+  uint32_t height = 480;
+};
+
+/**
+ * \brief Measurements for one corpus image.
+ *
+ * Encode time is measured with an EncodeHarness, so it is the plugin's encoding alone.
+ * Decode time is the rest of the publish to callback latency, so it includes middleware
+ * delivery.
+ */
+struct ConformanceResult
+{
+  std::string image;
+  size_t raw_bytes = 0;
+  size_t frames_sent = 0;
+  size_t frames_received = 0;
+  double encode_mbps = 0.0;
+  double decode_mbps = 0.0;
+  double mean_latency_us = 0.0;
+  double max_latency_us = 0.0;
+  /// Raw image bytes over serialized transport message bytes, 0 if it could not be measured.
+  double compression_ratio = 0.0;
+  /// Heap allocations per frame across the whole process, -1 if not counted.
+  double allocations_per_frame = -1.0;
+  /// True if every received image matched the published one exactly.
+  bool bit_exact = true;
+  /// Largest absolute difference between a published and a received byte, so 16 bit
+  /// encodings are compared byte-wise.
+  int max_abs_error = 0;
+};
+
+namespace detail
+{
+
+inline void compareImages(
+  const sensor_msgs::msg::Image & sent, const sensor_msgs::msg::Image & received,
+  ConformanceResult & result)
+{
+  if (sent.width != received.width || sent.height != received.height ||
+    sent.encoding != received.encoding || sent.data.size() != received.data.size())
+  {
+    result.bit_exact = false;
+    result.max_abs_error = 255;
+    return;
+  }
+  // Row by row, as the received step may differ from the published one.
+  const size_t row_bytes = sent.data.size() / std::max(sent.height, 1u);
+  for (uint32_t y = 0; y < sent.height; ++y) {
+    const uint8_t * a = &sent.data[y * sent.step];
+    const uint8_t * b = &received.data[y * received.step];
+    for (size_t i = 0; i < row_bytes; ++i) {
+      int error = std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i]));
+      if (error != 0) {
+        result.bit_exact = false;
+        result.max_abs_error = std::max(result.max_abs_error, error);
+      }
+    }
+  }
+}
+
+}  // namespace detail
+
+/**
+ * \brief Calls one transport's PublisherPlugin directly, with nothing listening, so the time
+ * spent in encode() is the plugin's encoding alone.
+ *
+ * The plugin is created from the static registry or with pluginlib and advertised on a
+ * private node that uses intra-process communication. Without subscribers rclcpp then
+ * drops the encoded message instead of serializing it. Throws pluginlib::PluginlibException
+ * if the transport cannot be loaded. rclcpp must be initialised.
+ */
+class EncodeHarness
+{
+public:
+  explicit EncodeHarness(const std::string & transport)
+  : node_(rclcpp::Node::make_shared(
+        "image_transport_encode_harness",
+        rclcpp::NodeOptions().use_intra_process_comms(true)))
+  {
+    const std::string lookup_name = "image_transport/" + transport + "_pub";
+    plugin_ = StaticTransportRegistry<rclcpp::Node>::instance().createPublisher(lookup_name);
+    if (!plugin_) {
+      loader_ = std::make_shared<PubLoader<rclcpp::Node>>(
+        "image_transport", "image_transport::PublisherPlugin<rclcpp::Node>");
+      plugin_ = loader_->createUniqueInstance(lookup_name);
+    }
+    plugin_->advertise(node_, "conformance/encode_only");
+  }
+
+  EncodeHarness(const EncodeHarness &) = delete;
+  EncodeHarness & operator=(const EncodeHarness &) = delete;
+
+  void encode(const sensor_msgs::msg::Image & image) const
+  {
+    plugin_->publish(image);
+  }
+
+private:
+  rclcpp::Node::SharedPtr node_;
+  // Declared before the plugin so that the plugin's library outlives it.
+  PubLoaderPtr<rclcpp::Node> loader_;
+  std::shared_ptr<PublisherPlugin<rclcpp::Node>> plugin_;
+};
+
+/**
+ * \brief Run the standard corpus through a transport and measure it.
+ *
+ * Publishes on a private node with only \a options.transport enabled and subscribes to it
+ * through image_transport, so any installed or statically registered transport can be
+ * measured. rclcpp must be initialised.
+ *
+ * This header only depends on what image_transport exports; executables that include it
+ * link pluginlib::pluginlib as well. Plugin packages check the results with their own test
+ * framework, as image_transport's test/test_conformance.cpp does with gtest for the raw
+ * transport, and can time EncodeHarness as test/benchmark/benchmark_conformance.cpp does.
+ */
+inline std::vector<ConformanceResult> runConformance(const ConformanceOptions & options)
+{
+  using Clock = std::chrono::steady_clock;
+
+  auto node = rclcpp::Node::make_shared(
+    "image_transport_conformance",
+    rclcpp::NodeOptions().use_intra_process_comms(false));
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+
+  const std::string base_topic = "conformance/image";
+  node->declare_parameter(
+    "conformance.image.enable_pub_plugins",
+    std::vector<std::string>{"image_transport/" + options.transport});
+
+  sensor_msgs::msg::Image::ConstSharedPtr last_received;
+  size_t received = 0;
+  auto pub = image_transport::create_publisher(node, base_topic);
+  auto sub = image_transport::create_subscription(
+    node, base_topic,
+    [&](const sensor_msgs::msg::Image::ConstSharedPtr & msg) {
+      last_received = msg;
+      ++received;
+    }, options.transport);
+
+  auto spin_until = [&](auto done) {
+      auto deadline = Clock::now() + options.timeout;
+      while (!done()) {
+        if (Clock::now() > deadline) {
+          return false;
+        }
+        executor.spin_some(std::chrono::milliseconds(1));
+      }
+      return true;
+    };
+
+  std::vector<ConformanceResult> results;
+  if (!spin_until([&]() {return pub.getNumSubscribers() > 0;})) {
+    return results;
+  }
+  // The publisher above already created the transport, so this rarely fails. If it does
+  // the encode rate is left at 0.
+  std::unique_ptr<EncodeHarness> encoder;
+  try {
+    encoder = std::make_unique<EncodeHarness>(options.transport);
+  } catch (const std::exception & e) {
+    RCLCPP_WARN(
+      node->get_logger(), "Cannot time the '%s' encoder alone: %s",
+      options.transport.c_str(), e.what());
+  }
+
+  // The transport's own topic, read as serialized bytes to measure the encoded size.
+  const std::string transport_topic = options.transport == "raw" ?
+    pub.getTopic() : pub.getTopic() + "/" + options.transport;
+  std::string transport_type;
+  spin_until(
+    [&]() {
+      auto topics = node->get_topic_names_and_types();
+      auto it = topics.find(node->get_node_topics_interface()->resolve_topic_name(
+        transport_topic));
+      if (it != topics.end() && !it->second.empty()) {
+        transport_type = it->second.front();
+      }
+      return !transport_type.empty();
+    });
+
+  for (const auto & entry : standardCorpus(options.width, options.height)) {
+    ConformanceResult result;
+    result.image = entry.name;
+    result.raw_bytes = entry.image.data.size();
+
+    size_t serialized_bytes = 0;
+    rclcpp::GenericSubscription::SharedPtr size_probe;
+    if (!transport_type.empty()) {
+      size_probe = node->create_generic_subscription(
+        transport_topic, transport_type, rclcpp::QoS(10),
+        [&serialized_bytes](std::shared_ptr<rclcpp::SerializedMessage> msg) {
+          serialized_bytes = msg->size();
+        });
+    }
+
+    for (size_t i = 0; i < options.warmup_frames; ++i) {
+      size_t expected = received + 1;
+      pub.publish(entry.image);
+      spin_until([&]() {return received >= expected && (!size_probe || serialized_bytes);});
+    }
+    if (serialized_bytes > 0) {
+      result.compression_ratio =
+        static_cast<double>(result.raw_bytes) / static_cast<double>(serialized_bytes);
+    }
+    // Keep the probe out of the timed frames and the allocation count.
+    size_probe.reset();
+
+    double encode_seconds = 0.0;
+    if (encoder) {
+      for (size_t i = 0; i < options.warmup_frames; ++i) {
+        encoder->encode(entry.image);
+      }
+      const auto t0 = Clock::now();
+      for (size_t i = 0; i < options.frames; ++i) {
+        encoder->encode(entry.image);
+      }
+      encode_seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    double latency_seconds = 0.0;
+    const uint64_t allocations_before = allocationCounter().load();
+    for (size_t i = 0; i < options.frames; ++i) {
+      const size_t expected = received + 1;
+      const auto t0 = Clock::now();
+      pub.publish(entry.image);
+      ++result.frames_sent;
+      if (!spin_until([&]() {return received >= expected;})) {
+        break;
+      }
+      const auto t1 = Clock::now();
+      ++result.frames_received;
+
+      const double latency = std::chrono::duration<double>(t1 - t0).count();
+      latency_seconds += latency;
+      result.max_latency_us = std::max(result.max_latency_us, latency * 1e6);
+      detail::compareImages(entry.image, *last_received, result);
+    }
+    const uint64_t allocations = allocationCounter().load() - allocations_before;
+
+    if (result.frames_received > 0) {
+      const double megabytes = static_cast<double>(result.raw_bytes) / 1e6;
+      const double mean_latency = latency_seconds / static_cast<double>(result.frames_received);
+      const double mean_encode = options.frames > 0 ?
+        encode_seconds / static_cast<double>(options.frames) : 0.0;
+      const double mean_decode = mean_latency - mean_encode;
+      result.encode_mbps = mean_encode > 0.0 ? megabytes / mean_encode : 0.0;
+      result.decode_mbps = mean_decode > 0.0 ? megabytes / mean_decode : 0.0;
+      result.mean_latency_us = mean_latency * 1e6;
+      if (allocationCountingEnabled()) {
+        result.allocations_per_frame = static_cast<double>(allocations) /
+          static_cast<double>(result.frames_received);
+      }
+    } else {
+      result.bit_exact = false;
+    }
+    results.push_back(result);
+  }
+  return results;
+}
+
+/**
+ * \brief Print results as a table, one row per corpus image.
+ */
+inline void printConformanceReport(
+  std::ostream & out, const std::string & transport,
+  const std::vector<ConformanceResult> & results)
+{
+  out << "image_transport conformance: " << transport << "\n";
+  out << std::left << std::setw(20) << "image" << std::right <<
+    std::setw(10) << "frames" <<
+    std::setw(12) << "enc MB/s" <<
+    std::setw(12) << "dec MB/s" <<
+    std::setw(12) << "lat us" <<
+    std::setw(10) << "ratio" <<
+    std::setw(10) << "allocs" <<
+    std::setw(11) << "bit-exact" << "\n";
+  for (const auto & result : results) {
+    out << std::left << std::setw(20) << result.image << std::right <<
+      std::setw(10) << (std::to_string(result.frames_received) + "/" +
+      std::to_string(result.frames_sent)) <<
+      std::fixed << std::setprecision(1) <<
+      std::setw(12) << result.encode_mbps <<
+      std::setw(12) << result.decode_mbps <<
+      std::setw(12) << result.mean_latency_us <<
+      std::setprecision(2) <<
+      std::setw(10) << result.compression_ratio <<
+      std::setprecision(1) <<
+      std::setw(10) << result.allocations_per_frame <<
+      std::setw(11) << (result.bit_exact ? "yes" : "no") << "\n";
+  }
+}
+
+}  // namespace testing
+}  // namespace image_transport
+
+#endif  // IMAGE_TRANSPORT__TESTING__CONFORMANCE_HPP_
@@ -0,0 +1,47 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Registers the raw transport with StaticTransportRegistry. Only compiled into
+// libimage_transport when the IMAGE_TRANSPORT_BUILTIN_RAW CMake option is ON.
+
+#include "image_transport/raw_publisher.hpp"
+#include "image_transport/raw_subscriber.hpp"
+#include "image_transport/static_transport_registry.hpp"
+
+IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(
+  rclcpp::Node, image_transport::RawPublisher<rclcpp::Node>, "image_transport/raw_pub")
+IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(
+  rclcpp_lifecycle::LifecycleNode,
+  image_transport::RawPublisher<rclcpp_lifecycle::LifecycleNode>,
+  "image_transport/raw_lifecycle_pub")
+IMAGE_TRANSPORT_REGISTER_STATIC_SUBSCRIBER(
+  rclcpp::Node, image_transport::RawSubscriber<rclcpp::Node>, "image_transport/raw_sub")
+IMAGE_TRANSPORT_REGISTER_STATIC_SUBSCRIBER(
+  rclcpp_lifecycle::LifecycleNode,
+  image_transport::RawSubscriber<rclcpp_lifecycle::LifecycleNode>,
+  "image_transport/raw_lifecycle_sub")
@@ -211,6 +211,25 @@ void CameraPublisher<NodeType>::publish(
   impl_->info_pub_->publish(std::move(info));
 }
 
+template<class NodeType>
+void CameraPublisher<NodeType>::publish(
+  sensor_msgs::msg::Image::UniquePtr image,
+  const sensor_msgs::msg::CameraInfo::ConstSharedPtr & info) const
+{
+  if (!impl_ || !impl_->isValid()) {
+    auto logger = impl_ ? impl_->logger_ : rclcpp::get_logger("image_transport");
+    RCLCPP_FATAL(
+      logger,
+      "Call to publish() on an invalid image_transport::CameraPublisher");
+    return;
+  }
+
+  auto info_msg = std::make_unique<sensor_msgs::msg::CameraInfo>(*info);
+  info_msg->header = image->header;
+  impl_->image_pub_.publish(std::move(image));
+  impl_->info_pub_->publish(std::move(info_msg));
+}
+
 template<class NodeType>
 void CameraPublisher<NodeType>::publish(
   sensor_msgs::msg::Image & image, sensor_msgs::msg::CameraInfo & info,
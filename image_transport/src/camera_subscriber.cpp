@@ -37,6 +37,8 @@
 #include "image_transport/camera_common.hpp"
 #include "image_transport/subscriber_filter.hpp"
 
+#include "isolated_callback_group.hpp"
+
 inline void increment(int * value)
 {
   ++(*value);
@@ -86,6 +88,9 @@ struct CameraSubscriber<NodeType>::Impl
       unsubscribed_ = true;
       image_sub_.unsubscribe();
       info_sub_.unsubscribe();
+      if (isolated_group_) {
+        isolated_group_->stop();
+      }
     }
   }
 
@@ -118,6 +123,8 @@ struct CameraSubscriber<NodeType>::Impl
   // For detecting when the topics aren't synchronized
   std::shared_ptr<rclcpp::TimerBase> check_synced_timer_;
   int image_received_, info_received_, both_received_;
+
+  std::shared_ptr<impl::IsolatedCallbackGroup> isolated_group_;
 };
 
 template<class NodeType>
@@ -126,10 +133,12 @@ CameraSubscriber<NodeType>::CameraSubscriber(
   const std::string & base_topic,
   const Callback & callback,
   const std::string & transport,
-  rmw_qos_profile_t custom_qos)
+  rmw_qos_profile_t custom_qos,
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 : impl_(std::make_shared<Impl>(node))
 {
-  initialise(base_topic, callback, transport, custom_qos);
+  initialise(base_topic, callback, transport, custom_qos, options, isolation);
 }
 
 template<class NodeType>
@@ -138,10 +147,12 @@ CameraSubscriber<NodeType>::CameraSubscriber(
   const std::string & base_topic,
   const Callback & callback,
   const std::string & transport,
-  rmw_qos_profile_t custom_qos)
+  rmw_qos_profile_t custom_qos,
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 : impl_(std::make_shared<Impl>(node))
 {
-  initialise(base_topic, callback, transport, custom_qos);
+  initialise(base_topic, callback, transport, custom_qos, options, isolation);
 }
 
 template<class NodeType>
@@ -149,11 +160,19 @@ void CameraSubscriber<NodeType>::initialise(
   const std::string & base_topic,
   const Callback & callback,
   const std::string & transport,
-  rmw_qos_profile_t custom_qos)
+  rmw_qos_profile_t custom_qos,
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 {
   if (!impl_) {
     throw std::runtime_error("impl is not constructed!");
   }
+  // Both subscriptions share one group so the synchronizer only ever runs on one thread.
+  if (isolation.enabled()) {
+    impl_->isolated_group_ = std::make_shared<impl::IsolatedCallbackGroup>(
+      impl_->node_->get_node_base_interface(), isolation, impl_->logger_);
+    options.callback_group = impl_->isolated_group_->getCallbackGroup();
+  }
   // Must explicitly remap the image topic since we then do some string manipulation on it
   // to figure out the sibling camera_info topic.
   std::string image_topic;
@@ -162,9 +181,9 @@ void CameraSubscriber<NodeType>::initialise(
     impl_->node_->get_name(), impl_->node_->get_namespace());
   std::string info_topic = getCameraInfoTopic(image_topic);
 
-  impl_->image_sub_.subscribe(impl_->node_, image_topic, transport, custom_qos);
+  impl_->image_sub_.subscribe(impl_->node_, image_topic, transport, custom_qos, options);
   impl_->info_sub_.subscribe(impl_->node_, info_topic,
-    rclcpp::QoS(rclcpp::QoSInitialization::from_rmw(custom_qos)));
+    rclcpp::QoS(rclcpp::QoSInitialization::from_rmw(custom_qos)), options);
 
   impl_->sync_.connectInput(impl_->image_sub_, impl_->info_sub_);
   impl_->info_sub_.registerCallback(std::bind(increment, &impl_->info_received_));
@@ -175,9 +194,10 @@ void CameraSubscriber<NodeType>::initialise(
   impl_->image_sub_.registerCallback(std::bind(increment, &impl_->image_received_));
   impl_->sync_.registerCallback(std::bind(increment, &impl_->both_received_));
 
+  // The check resets the counters, so it runs in the group of the callbacks that count.
   impl_->check_synced_timer_ = impl_->node_->create_wall_timer(
     std::chrono::seconds(1),
-    std::bind(&Impl::checkImagesSynchronized, impl_.get()));
+    std::bind(&Impl::checkImagesSynchronized, impl_.get()), options.callback_group);
 }
 
 template<class NodeType>
@@ -0,0 +1,57 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef DEFAULT_LOADERS_HPP_
+#define DEFAULT_LOADERS_HPP_
+
+#include "image_transport/loader_fwds.hpp"
+
+namespace image_transport
+{
+namespace impl
+{
+
+/**
+ * \brief The process-wide pluginlib loaders used when Publisher and Subscriber are not
+ * given one.
+ *
+ * Constructing a loader parses every plugin manifest, so each is built on first use rather
+ * than at static initialisation. A process whose transports are all statically registered
+ * never builds them. Defined in image_transport.cpp for rclcpp::Node and
+ * rclcpp_lifecycle::LifecycleNode.
+ */
+template<class NodeType>
+PubLoaderPtr<NodeType> getDefaultPubLoader();
+
+template<class NodeType>
+SubLoaderPtr<NodeType> getDefaultSubLoader();
+
+}  // namespace impl
+}  // namespace image_transport
+
+#endif  // DEFAULT_LOADERS_HPP_
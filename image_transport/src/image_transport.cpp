@@ -28,8 +28,16 @@
 
 #include "image_transport/image_transport.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "pluginlib/class_loader.hpp"
@@ -37,45 +45,120 @@
 #include "image_transport/camera_common.hpp"
 #include "image_transport/loader_fwds.hpp"
 #include "image_transport/publisher_plugin.hpp"
+#include "image_transport/static_transport_registry.hpp"
 #include "image_transport/subscriber_plugin.hpp"
 
+#include "default_loaders.hpp"
+#include "transport_index.hpp"
+
 namespace image_transport
 {
 
-struct Impl
+namespace impl
 {
-  PubLoaderPtr<rclcpp::Node> pub_loader_;
-  SubLoaderPtr<rclcpp::Node> sub_loader_;
 
-  Impl()
-  : pub_loader_(std::make_shared<PubLoader<rclcpp::Node>>(
-        "image_transport",
-        "image_transport::PublisherPlugin<rclcpp::Node>")),
-    sub_loader_(std::make_shared<SubLoader<rclcpp::Node>>(
-        "image_transport",
-        "image_transport::SubscriberPlugin<rclcpp::Node>"))
-  {
+namespace
+{
+
+template<class NodeType>
+std::string publisherBaseClass()
+{
+  if constexpr (std::is_same_v<NodeType, rclcpp_lifecycle::LifecycleNode>) {
+    return "image_transport::PublisherPlugin<rclcpp_lifecycle::LifecycleNode>";
+  } else {
+    return "image_transport::PublisherPlugin<rclcpp::Node>";
+  }
+}
+
+template<class NodeType>
+std::string subscriberBaseClass()
+{
+  if constexpr (std::is_same_v<NodeType, rclcpp_lifecycle::LifecycleNode>) {
+    return "image_transport::SubscriberPlugin<rclcpp_lifecycle::LifecycleNode>";
+  } else {
+    return "image_transport::SubscriberPlugin<rclcpp::Node>";
   }
+}
+
+}  // namespace
+
+// The loaders are leaked on purpose so they outlive static destruction.
+template<class NodeType>
+PubLoaderPtr<NodeType> getDefaultPubLoader()
+{
+  static auto * loader = new PubLoaderPtr<NodeType>(
+    std::make_shared<PubLoader<NodeType>>("image_transport", publisherBaseClass<NodeType>()));
+  return *loader;
+}
+
+template<class NodeType>
+SubLoaderPtr<NodeType> getDefaultSubLoader()
+{
+  static auto * loader = new SubLoaderPtr<NodeType>(
+    std::make_shared<SubLoader<NodeType>>("image_transport", subscriberBaseClass<NodeType>()));
+  return *loader;
+}
+
+template PubLoaderPtr<rclcpp::Node> getDefaultPubLoader<rclcpp::Node>();
+template PubLoaderPtr<rclcpp_lifecycle::LifecycleNode>
+getDefaultPubLoader<rclcpp_lifecycle::LifecycleNode>();
+template SubLoaderPtr<rclcpp::Node> getDefaultSubLoader<rclcpp::Node>();
+template SubLoaderPtr<rclcpp_lifecycle::LifecycleNode>
+getDefaultSubLoader<rclcpp_lifecycle::LifecycleNode>();
+
+}  // namespace impl
+
+namespace impl
+{
+
+namespace
+{
+
+struct TransportIndexEntry
+{
+  std::weak_ptr<const void> loader;
+  std::shared_ptr<const TransportIndex> index;
 };
 
-struct ImplLifecycle
+using TransportIndexCache = std::map<std::pair<const void *, std::string>, TransportIndexEntry>;
+
+// Leaked on purpose, like the default loaders, so they outlive static destruction.
+std::mutex & transportIndexMutex()
 {
-  PubLoaderPtr<rclcpp_lifecycle::LifecycleNode> pub_loader_;
-  SubLoaderPtr<rclcpp_lifecycle::LifecycleNode> sub_loader_;
+  static auto * mutex = new std::mutex();
+  return *mutex;
+}
 
-  ImplLifecycle()
-  : pub_loader_(std::make_shared<PubLoader<rclcpp_lifecycle::LifecycleNode>>(
-        "image_transport",
-        "image_transport::PublisherPlugin<rclcpp_lifecycle::LifecycleNode>")),
-    sub_loader_(std::make_shared<SubLoader<rclcpp_lifecycle::LifecycleNode>>(
-        "image_transport",
-        "image_transport::SubscriberPlugin<rclcpp_lifecycle::LifecycleNode>"))
-  {
+TransportIndexCache & transportIndexCache()
+{
+  static auto * cache = new TransportIndexCache();
+  return *cache;
+}
+
+}  // namespace
+
+std::shared_ptr<const TransportIndex> getTransportIndex(
+  const std::shared_ptr<const void> & loader,
+  const std::function<std::vector<std::string>()> & declared_classes,
+  const std::string & suffix)
+{
+  std::lock_guard<std::mutex> lock(transportIndexMutex());
+  auto * cache = &transportIndexCache();
+  auto key = std::make_pair(loader.get(), suffix);
+  auto it = cache->find(key);
+  // A destroyed loader's address may be reused by a new one, so check it is still alive.
+  if (it != cache->end() && it->second.loader.lock() == loader) {
+    return it->second.index;
   }
-};
+  for (auto entry = cache->begin(); entry != cache->end(); ) {
+    entry = entry->second.loader.expired() ? cache->erase(entry) : std::next(entry);
+  }
+  auto index = std::make_shared<const TransportIndex>(declared_classes(), suffix);
+  (*cache)[key] = TransportIndexEntry{loader, index};
+  return index;
+}
 
-static Impl * kImpl = new Impl();
-static ImplLifecycle * kImpl_lifecycle = new ImplLifecycle();
+}  // namespace impl
 
 template<class NodeType>
 Publisher<NodeType> create_publisher(
@@ -84,12 +167,8 @@ Publisher<NodeType> create_publisher(
   rmw_qos_profile_t custom_qos,
   rclcpp::PublisherOptions options)
 {
-  if constexpr (std::is_same_v<NodeType, rclcpp::Node>) {
-    return Publisher(node, base_topic, kImpl->pub_loader_, custom_qos, options);
-  }
-  if constexpr (std::is_same_v<NodeType, rclcpp_lifecycle::LifecycleNode>) {
-    return Publisher(node, base_topic, kImpl_lifecycle->pub_loader_, custom_qos, options);
-  }
+  // A null loader makes the Publisher use the default one if it needs pluginlib at all.
+  return Publisher(node, base_topic, PubLoaderPtr<NodeType>(), custom_qos, options);
 }
 
 template<class NodeType>
@@ -99,12 +178,8 @@ Publisher<NodeType> create_publisher(
   rmw_qos_profile_t custom_qos,
   rclcpp::PublisherOptions options)
 {
-  if constexpr (std::is_same_v<NodeType, rclcpp::Node>) {
-    return Publisher(node, base_topic, kImpl->pub_loader_, custom_qos, options);
-  }
-  if constexpr (std::is_same_v<NodeType, rclcpp_lifecycle::LifecycleNode>) {
-    return Publisher(node, base_topic, kImpl_lifecycle->pub_loader_, custom_qos, options);
-  }
+  // A null loader makes the Publisher use the default one if it needs pluginlib at all.
+  return Publisher(node, base_topic, PubLoaderPtr<NodeType>(), custom_qos, options);
 }
 
 template<class NodeType>
@@ -114,17 +189,18 @@ Subscriber<NodeType> create_subscription(
   const typename Subscriber<NodeType>::Callback & callback,
   const std::string & transport,
   rmw_qos_profile_t custom_qos,
-  rclcpp::SubscriptionOptions options)
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 {
   if constexpr (std::is_same_v<NodeType, rclcpp::Node>) {
     return Subscriber(
-      node, base_topic, callback, kImpl->sub_loader_, transport, custom_qos,
-      options);
+      node, base_topic, callback, SubLoaderPtr<NodeType>(), transport, custom_qos,
+      options, isolation);
   }
   if constexpr (std::is_same_v<NodeType, rclcpp_lifecycle::LifecycleNode>) {
     return Subscriber(
-      node, base_topic, callback, kImpl_lifecycle->sub_loader_,
-      transport + "_lifecycle", custom_qos, options);
+      node, base_topic, callback, SubLoaderPtr<NodeType>(),
+      transport + "_lifecycle", custom_qos, options, isolation);
   }
 }
 
@@ -135,17 +211,18 @@ Subscriber<NodeType> create_subscription(
   const typename Subscriber<NodeType>::Callback & callback,
   const std::string & transport,
   rmw_qos_profile_t custom_qos,
-  rclcpp::SubscriptionOptions options)
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 {
   if constexpr (std::is_same_v<NodeType, rclcpp::Node>) {
     return Subscriber(
-      node, base_topic, callback, kImpl->sub_loader_, transport, custom_qos,
-      options);
+      node, base_topic, callback, SubLoaderPtr<NodeType>(), transport, custom_qos,
+      options, isolation);
   }
   if constexpr (std::is_same_v<NodeType, rclcpp_lifecycle::LifecycleNode>) {
     return Subscriber(
-      node, base_topic, callback, kImpl_lifecycle->sub_loader_,
-      transport + "_lifecycle", custom_qos, options);
+      node, base_topic, callback, SubLoaderPtr<NodeType>(),
+      transport + "_lifecycle", custom_qos, options, isolation);
   }
 }
 
@@ -175,9 +252,12 @@ CameraSubscriber<NodeType> create_camera_subscription(
   const std::string & base_topic,
   const typename CameraSubscriber<NodeType>::Callback & callback,
   const std::string & transport,
-  rmw_qos_profile_t custom_qos)
+  rmw_qos_profile_t custom_qos,
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 {
-  return CameraSubscriber(node, base_topic, callback, transport, custom_qos);
+  return CameraSubscriber(
+    node, base_topic, callback, transport, custom_qos, options, isolation);
 }
 
 template<class NodeType>
@@ -186,61 +266,163 @@ CameraSubscriber<NodeType> create_camera_subscription(
   const std::string & base_topic,
   const typename CameraSubscriber<NodeType>::Callback & callback,
   const std::string & transport,
-  rmw_qos_profile_t custom_qos)
+  rmw_qos_profile_t custom_qos,
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 {
-  return CameraSubscriber(node, base_topic, callback, transport, custom_qos);
+  return CameraSubscriber(
+    node, base_topic, callback, transport, custom_qos, options, isolation);
 }
 
 template<class NodeType>
 std::vector<std::string> getDeclaredTransports()
 {
-  std::vector<std::string> transports;
-  if constexpr (std::is_same_v<NodeType, rclcpp::Node>) {
-    transports = kImpl->sub_loader_->getDeclaredClasses();
+  std::shared_ptr<const impl::TransportIndex> index =
+    impl::getTransportIndex(impl::getDefaultSubLoader<NodeType>(), "_sub");
+  // Transport names have the "_sub" at the end of each class name removed.
+  std::vector<std::string> transports = index->transportNames();
+  for (const auto & lookup_name :
+    StaticTransportRegistry<NodeType>::instance().getSubscriberLookupNames())
+  {
+    if (!index->hasLookupName(lookup_name)) {
+      transports.push_back(erase_last_copy(lookup_name, "_sub"));
+    }
   }
-  if constexpr (std::is_same_v<NodeType, rclcpp_lifecycle::LifecycleNode>) {
-    transports = kImpl_lifecycle->sub_loader_->getDeclaredClasses();
+  return transports;
+}
+
+namespace
+{
+
+using ManifestFingerprint = std::vector<std::filesystem::file_time_type>;
+
+/**
+ * Modification times of the plugin manifests a loader was built from, and of the ament
+ * index directories through which packages register new manifests.
+ */
+ManifestFingerprint manifestFingerprint(const std::vector<std::string> & xml_paths)
+{
+  ManifestFingerprint fingerprint;
+  std::error_code ec;  // Missing files simply yield file_time_type::min().
+  for (const auto & path : xml_paths) {
+    fingerprint.push_back(std::filesystem::last_write_time(path, ec));
   }
-  // Remove the "_sub" at the end of each class name.
-  for (std::string & transport : transports) {
-    transport = erase_last_copy(transport, "_sub");
+#ifdef _WIN32
+  const char separator = ';';
+#else
+  const char separator = ':';
+#endif
+  const char * ament_prefix_path = std::getenv("AMENT_PREFIX_PATH");
+  std::string prefixes = ament_prefix_path ? ament_prefix_path : "";
+  size_t begin = 0;
+  while (begin <= prefixes.size()) {
+    size_t end = std::min(prefixes.find(separator, begin), prefixes.size());
+    if (end > begin) {
+      fingerprint.push_back(
+        std::filesystem::last_write_time(
+          prefixes.substr(begin, end - begin) +
+          "/share/ament_index/resource_index/image_transport__pluginlib__plugin", ec));
+    }
+    begin = end + 1;
   }
-  return transports;
+  return fingerprint;
 }
 
+/**
+ * Try to instantiate every declared subscriber plugin and return the transport names of
+ * those that load, in declaration order.
+ *
+ * pluginlib::ClassLoader is not thread safe, so each worker probes its share of the
+ * plugins with a loader of its own. class_loader still serializes the dlopen() calls
+ * themselves, but library lookup and plugin construction run in parallel.
+ */
 template<class NodeType>
-std::vector<std::string> getLoadableTransports()
+std::vector<std::string> probeLoadableTransports(
+  const std::vector<std::string> & lookup_names, const std::string & base_class)
 {
-  std::vector<std::string> loadableTransports;
-  std::vector<std::string> transports;
-  if constexpr (std::is_same_v<NodeType, rclcpp::Node>) {
-    transports = kImpl->sub_loader_->getDeclaredClasses();
+  std::vector<char> loadable(lookup_names.size(), 0);
+  size_t num_workers = std::min<size_t>(
+    lookup_names.size(), std::max(1u, std::thread::hardware_concurrency()));
+
+  auto probe = [&](size_t worker) {
+      SubLoaderPtr<NodeType> loader = std::make_shared<SubLoader<NodeType>>(
+        "image_transport", base_class);
+      for (size_t i = worker; i < lookup_names.size(); i += num_workers) {
+        // If the plugin loads without throwing an exception, add its
+        // transport name to the list of valid plugins, otherwise ignore
+        // it.
+        try {
+          auto sub = loader->createUniqueInstance(lookup_names[i]);
+          loadable[i] = 1;
+        } catch (const pluginlib::LibraryLoadException & e) {
+          (void) e;
+        } catch (const pluginlib::CreateClassException & e) {
+          (void) e;
+        }
+      }
+    };
+  std::vector<std::thread> workers;
+  for (size_t worker = 1; worker < num_workers; ++worker) {
+    workers.emplace_back(probe, worker);
   }
-  if constexpr (std::is_same_v<NodeType, rclcpp_lifecycle::LifecycleNode>) {
-    transports = kImpl_lifecycle->sub_loader_->getDeclaredClasses();
+  if (num_workers > 0) {
+    probe(0);
   }
-  for (const std::string & transportPlugin : transports) {
-    // If the plugin loads without throwing an exception, add its
-    // transport name to the list of valid plugins, otherwise ignore
-    // it.
-    try {
-      std::shared_ptr<image_transport::SubscriberPlugin<NodeType>> sub;
-      if constexpr (std::is_same_v<NodeType, rclcpp::Node>) {
-        sub = kImpl->sub_loader_->createUniqueInstance(transportPlugin);
-      }
-      if constexpr (std::is_same_v<NodeType, rclcpp_lifecycle::LifecycleNode>) {
-        sub = kImpl_lifecycle->sub_loader_->createUniqueInstance(transportPlugin);
-      }
+  for (auto & worker : workers) {
+    worker.join();
+  }
+
+  std::vector<std::string> loadable_transports;
+  for (size_t i = 0; i < lookup_names.size(); ++i) {
+    if (loadable[i]) {
       // Remove the "_sub" at the end of each class name.
-      loadableTransports.push_back(erase_last_copy(transportPlugin, "_sub"));
-    } catch (const pluginlib::LibraryLoadException & e) {
-      (void) e;
-    } catch (const pluginlib::CreateClassException & e) {
-      (void) e;
+      loadable_transports.push_back(erase_last_copy(lookup_names[i], "_sub"));
     }
   }
+  return loadable_transports;
+}
+
+}  // namespace
 
-  return loadableTransports;
+template<class NodeType>
+std::vector<std::string> getLoadableTransports()
+{
+  // Probing loads every plugin library, so the result is cached for the lifetime of the
+  // process and only recomputed when a plugin manifest changes.
+  static std::mutex mutex;
+  static std::optional<ManifestFingerprint> fingerprint;
+  static std::vector<std::string> xml_paths;
+  static std::vector<std::string> loadable_transports;
+
+  // The default loaders are used by Publisher and Subscriber without locking, so they are
+  // never refreshed here.
+  const std::string base_class = impl::subscriberBaseClass<NodeType>();
+
+  std::vector<std::string> transports;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!fingerprint || *fingerprint != manifestFingerprint(xml_paths)) {
+      // A private loader reads the manifests as they are now, picking up added or removed
+      // plugins, which may also change the manifest paths.
+      SubLoader<NodeType> loader("image_transport", base_class);
+      xml_paths = loader.getPluginXmlPaths();
+      loadable_transports = probeLoadableTransports<NodeType>(
+        loader.getDeclaredClasses(), base_class);
+      fingerprint = manifestFingerprint(xml_paths);
+    }
+    transports = loadable_transports;
+  }
+
+  // Statically linked transports are always loadable.
+  for (const auto & lookup_name :
+    StaticTransportRegistry<NodeType>::instance().getSubscriberLookupNames())
+  {
+    std::string transport = erase_last_copy(lookup_name, "_sub");
+    if (std::find(transports.begin(), transports.end(), transport) == transports.end()) {
+      transports.push_back(transport);
+    }
+  }
+  return transports;
 }
 
 template<class NodeType>
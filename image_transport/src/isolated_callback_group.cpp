@@ -0,0 +1,141 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "isolated_callback_group.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <utility>
+
+#include "rclcpp/logging.hpp"
+
+namespace image_transport
+{
+namespace impl
+{
+
+namespace
+{
+
+void applySchedulingSettings(const CallbackIsolation & isolation, const rclcpp::Logger & logger)
+{
+#ifdef __linux__
+  if (!isolation.cpu_affinity.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : isolation.cpu_affinity) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &cpu_set);
+      }
+    }
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (ret != 0) {
+      RCLCPP_WARN(
+        logger, "[image_transport] Failed to set executor thread CPU affinity: %s",
+        strerror(ret));
+    }
+  }
+  if (isolation.priority > 0) {
+    sched_param param{};
+    param.sched_priority = isolation.priority;
+    int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (ret != 0) {
+      RCLCPP_WARN(
+        logger, "[image_transport] Failed to set executor thread priority %d: %s",
+        isolation.priority, strerror(ret));
+    }
+  }
+#else
+  if (!isolation.cpu_affinity.empty() || isolation.priority > 0) {
+    RCLCPP_WARN(
+      logger, "[image_transport] CPU affinity and priority are only supported on Linux");
+  }
+#endif
+}
+
+}  // namespace
+
+IsolatedCallbackGroup::IsolatedCallbackGroup(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+  const CallbackIsolation & isolation,
+  const rclcpp::Logger & logger)
+: logger_(logger)
+{
+  // A group spun by a private executor must not also be picked up by the node's executor.
+  callback_group_ = node_base->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive,
+    !isolation.dedicated_executor_thread);
+
+  if (!isolation.dedicated_executor_thread) {
+    return;
+  }
+  executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  executor_->add_callback_group(callback_group_, node_base);
+  std::promise<void> finished;
+  thread_finished_ = finished.get_future();
+  thread_ = std::thread(
+    [executor = executor_, isolation, logger = logger_, finished = std::move(finished)]() mutable {
+      applySchedulingSettings(isolation, logger);
+      executor->spin();
+      finished.set_value();
+    });
+}
+
+IsolatedCallbackGroup::~IsolatedCallbackGroup()
+{
+  stop();
+}
+
+void IsolatedCallbackGroup::stop()
+{
+  if (!thread_.joinable()) {
+    return;
+  }
+  // Shutting down from one of our own callbacks: the thread exits once it returns.
+  if (thread_.get_id() == std::this_thread::get_id()) {
+    executor_->cancel();
+    thread_.detach();
+    return;
+  }
+  // A cancel() that comes before the thread enters spin() is lost, spin() starts over, so
+  // repeat it until the thread is done.
+  do {
+    executor_->cancel();
+  } while (thread_finished_.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready);
+  thread_.join();
+}
+
+}  // namespace impl
+}  // namespace image_transport
@@ -0,0 +1,83 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef ISOLATED_CALLBACK_GROUP_HPP_
+#define ISOLATED_CALLBACK_GROUP_HPP_
+
+#include <future>
+#include <memory>
+#include <thread>
+
+#include "rclcpp/callback_group.hpp"
+#include "rclcpp/executors/single_threaded_executor.hpp"
+#include "rclcpp/logger.hpp"
+#include "rclcpp/node_interfaces/node_base_interface.hpp"
+
+#include "image_transport/callback_isolation.hpp"
+
+namespace image_transport
+{
+namespace impl
+{
+
+/**
+ * \brief Owns the callback group, and optionally the executor thread, requested by a
+ * CallbackIsolation.
+ */
+class IsolatedCallbackGroup
+{
+public:
+  IsolatedCallbackGroup(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+    const CallbackIsolation & isolation,
+    const rclcpp::Logger & logger);
+
+  ~IsolatedCallbackGroup();
+
+  IsolatedCallbackGroup(const IsolatedCallbackGroup &) = delete;
+  IsolatedCallbackGroup & operator=(const IsolatedCallbackGroup &) = delete;
+
+  rclcpp::CallbackGroup::SharedPtr getCallbackGroup() const {return callback_group_;}
+
+  /**
+   * \brief Stop the private executor thread, if any. Safe to call more than once.
+   */
+  void stop();
+
+private:
+  rclcpp::Logger logger_;
+  rclcpp::CallbackGroup::SharedPtr callback_group_;
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> executor_;
+  std::thread thread_;
+  std::future<void> thread_finished_;
+};
+
+}  // namespace impl
+}  // namespace image_transport
+
+#endif  // ISOLATED_CALLBACK_GROUP_HPP_
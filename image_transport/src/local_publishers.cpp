@@ -0,0 +1,87 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "local_publishers.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace image_transport
+{
+namespace impl
+{
+
+namespace
+{
+
+std::mutex & registryMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+// Number of local publishers per (base topic, transport).
+std::map<std::pair<std::string, std::string>, size_t> & registry()
+{
+  static std::map<std::pair<std::string, std::string>, size_t> topics;
+  return topics;
+}
+
+}  // namespace
+
+void registerLocalPublisher(const std::string & topic, const std::vector<std::string> & transports)
+{
+  std::lock_guard<std::mutex> lock(registryMutex());
+  for (const auto & transport : transports) {
+    ++registry()[{topic, transport}];
+  }
+}
+
+void unregisterLocalPublisher(
+  const std::string & topic, const std::vector<std::string> & transports)
+{
+  std::lock_guard<std::mutex> lock(registryMutex());
+  for (const auto & transport : transports) {
+    auto it = registry().find({topic, transport});
+    if (it != registry().end() && --it->second == 0) {
+      registry().erase(it);
+    }
+  }
+}
+
+bool hasLocalPublisher(const std::string & topic, const std::string & transport)
+{
+  std::lock_guard<std::mutex> lock(registryMutex());
+  return registry().count({topic, transport}) > 0;
+}
+
+}  // namespace impl
+}  // namespace image_transport
@@ -0,0 +1,61 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef LOCAL_PUBLISHERS_HPP_
+#define LOCAL_PUBLISHERS_HPP_
+
+#include <string>
+#include <vector>
+
+namespace image_transport
+{
+namespace impl
+{
+
+/**
+ * \brief Record that a Publisher in this process advertises the fully resolved
+ * base topic \a topic with \a transports, given by their base names ("raw", "compressed").
+ *
+ * Registrations are counted, so every call must be balanced by a call to
+ * unregisterLocalPublisher() with the same arguments.
+ */
+void registerLocalPublisher(const std::string & topic, const std::vector<std::string> & transports);
+
+void unregisterLocalPublisher(
+  const std::string & topic, const std::vector<std::string> & transports);
+
+/**
+ * \brief Returns true if some Publisher in this process currently advertises \a topic
+ * with \a transport.
+ */
+bool hasLocalPublisher(const std::string & topic, const std::string & transport);
+
+}  // namespace impl
+}  // namespace image_transport
+
+#endif  // LOCAL_PUBLISHERS_HPP_
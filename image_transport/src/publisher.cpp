@@ -28,7 +28,10 @@
 
 #include "image_transport/publisher.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
@@ -43,16 +46,43 @@
 
 #include "image_transport/camera_common.hpp"
 #include "image_transport/publisher_plugin.hpp"
+#include "image_transport/static_transport_registry.hpp"
+
+#include "default_loaders.hpp"
+#include "local_publishers.hpp"
+#include "transport_index.hpp"
 
 namespace image_transport
 {
 
+namespace
+{
+
+// The name subscribers select a transport by, e.g. "raw" for "image_transport/raw_lifecycle".
+std::string transportBaseName(const std::string & transport_name)
+{
+  std::string name = transport_name.substr(transport_name.find_last_of('/') + 1);
+  const std::string lifecycle_suffix = "_lifecycle";
+  if (name.size() > lifecycle_suffix.size() &&
+    name.compare(name.size() - lifecycle_suffix.size(), lifecycle_suffix.size(),
+    lifecycle_suffix) == 0)
+  {
+    name.erase(name.size() - lifecycle_suffix.size());
+  }
+  return name;
+}
+
+}  // namespace
+
 template<class NodeType>
 struct Publisher<NodeType>::Impl
 {
+  using PluginList = std::vector<std::shared_ptr<PublisherPlugin<NodeType>>>;
+
   explicit Impl(NodeType * node)
   : node_(node),
     logger_(node->get_logger()),
+    publishers_(std::make_shared<const PluginList>()),
     unadvertised_(false)
   {
   }
@@ -60,6 +90,7 @@ struct Publisher<NodeType>::Impl
   explicit Impl(std::shared_ptr<NodeType> node)
   : node_(node),
     logger_(node->get_logger()),
+    publishers_(std::make_shared<const PluginList>()),
     unadvertised_(false)
   {
   }
@@ -69,10 +100,25 @@ struct Publisher<NodeType>::Impl
     shutdown();
   }
 
+  /**
+   * The plugins currently advertised. publish() works on this snapshot without locking;
+   * changes replace the whole list under mutex_.
+   */
+  std::shared_ptr<const PluginList> getPublishers() const
+  {
+    return std::atomic_load(&publishers_);
+  }
+
+  // Must be called with mutex_ held.
+  void setPublishers(PluginList publishers)
+  {
+    std::atomic_store(&publishers_, std::make_shared<const PluginList>(std::move(publishers)));
+  }
+
   size_t getNumSubscribers() const
   {
     size_t count = 0;
-    for (const auto & pub : publishers_) {
+    for (const auto & pub : *getPublishers()) {
       count += pub->getNumSubscribers();
     }
     return count;
@@ -90,12 +136,105 @@ struct Publisher<NodeType>::Impl
 
   void shutdown()
   {
+    if (lazy_timer_) {
+      lazy_timer_->cancel();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!unadvertised_) {
       unadvertised_ = true;
-      for (auto & pub : publishers_) {
+      auto publishers = getPublishers();
+      setPublishers(PluginList());
+      for (auto & pub : *publishers) {
         pub->shutdown();
       }
-      publishers_.clear();
+      if (registered_) {
+        impl::unregisterLocalPublisher(base_topic_, local_transports_);
+        registered_ = false;
+      }
+    }
+  }
+
+  /**
+   * Create the plugin registered as \a lookup_name, preferring statically linked
+   * transports over pluginlib.
+   */
+  std::shared_ptr<PublisherPlugin<NodeType>> createPlugin(const std::string & lookup_name) const
+  {
+    auto pub = StaticTransportRegistry<NodeType>::instance().createPublisher(lookup_name);
+    if (pub) {
+      return pub;
+    }
+    return pluginLoader()->createUniqueInstance(lookup_name);
+  }
+
+  /// The loader given on construction, or the default one, which is only built on demand.
+  PubLoaderPtr<NodeType> pluginLoader() const
+  {
+    return loader_ ? loader_ : impl::getDefaultPubLoader<NodeType>();
+  }
+
+  /**
+   * A plugin listed in "lazy_pub_plugins". It is only instantiated and advertised while
+   * somebody subscribes to its transport-specific topic.
+   */
+  struct LazyPlugin
+  {
+    std::string lookup_name;
+    std::string topic;
+    std::shared_ptr<PublisherPlugin<NodeType>> plugin;
+    std::chrono::steady_clock::time_point idle_since;
+  };
+
+  void updateLazyPlugins()
+  {
+    auto now = std::chrono::steady_clock::now();
+    for (auto & lazy : lazy_plugins_) {
+      if (!lazy.plugin) {
+        if (node_->count_subscribers(lazy.topic) == 0) {
+          continue;
+        }
+        RCLCPP_DEBUG(logger_, "Waking up plugin %s for %s", lazy.lookup_name.c_str(),
+          lazy.topic.c_str());
+        std::shared_ptr<PublisherPlugin<NodeType>> pub;
+        try {
+          pub = createPlugin(lazy.lookup_name);
+          pub->advertise(node_, base_topic_, custom_qos_, options_);
+        } catch (const std::runtime_error & e) {
+          RCLCPP_ERROR(
+            logger_, "Failed to load plugin %s, error string: %s\n",
+            lazy.lookup_name.c_str(), e.what());
+          continue;
+        }
+        if (pub->getTopic() != lazy.topic) {
+          RCLCPP_WARN(
+            logger_, "Plugin %s advertises %s, not %s; set its lazy_topic parameter",
+            lazy.lookup_name.c_str(), pub->getTopic().c_str(), lazy.topic.c_str());
+          lazy.topic = pub->getTopic();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (unadvertised_) {
+          pub->shutdown();
+          return;
+        }
+        lazy.plugin = pub;
+        lazy.idle_since = now;
+        PluginList publishers = *getPublishers();
+        publishers.push_back(std::move(pub));
+        setPublishers(std::move(publishers));
+      } else if (lazy.plugin->getNumSubscribers() > 0) {
+        lazy.idle_since = now;
+      } else if (now - lazy.idle_since >= lazy_grace_period_) {
+        RCLCPP_DEBUG(logger_, "Putting plugin %s for %s back to sleep",
+          lazy.lookup_name.c_str(), lazy.topic.c_str());
+        // No shutdown(): a publish() may still be using an older snapshot. The plugin
+        // unadvertises when the last snapshot holding it is released.
+        std::lock_guard<std::mutex> lock(mutex_);
+        PluginList publishers = *getPublishers();
+        publishers.erase(
+          std::remove(publishers.begin(), publishers.end(), lazy.plugin), publishers.end());
+        setPublishers(std::move(publishers));
+        lazy.plugin.reset();
+      }
     }
   }
 
@@ -103,8 +242,19 @@ struct Publisher<NodeType>::Impl
   rclcpp::Logger logger_;
   std::string base_topic_;
   PubLoaderPtr<NodeType> loader_;
-  std::vector<std::shared_ptr<PublisherPlugin<NodeType>>> publishers_;
+  std::shared_ptr<const PluginList> publishers_;
   bool unadvertised_;
+  bool registered_ = false;
+  // Base names of the transports registered as served from this process.
+  std::vector<std::string> local_transports_;
+
+  // Serialises changes to publishers_, which the lazy plugin timer makes.
+  mutable std::mutex mutex_;
+  rmw_qos_profile_t custom_qos_;
+  rclcpp::PublisherOptions options_;
+  std::vector<LazyPlugin> lazy_plugins_;
+  std::chrono::steady_clock::duration lazy_grace_period_;
+  rclcpp::TimerBase::SharedPtr lazy_timer_;
 };
 
 template<class NodeType>
@@ -153,13 +303,28 @@ void Publisher<NodeType>::initialise(
   }
   std::vector<std::string> allowlist_vec;
   std::set<std::string> allowlist;
+  // The default enables every declared transport, which means reading the plugin manifests.
+  // Skip that when the parameter is set anyway, so a Publisher whose transports are all
+  // statically registered never touches pluginlib.
+  const std::string allowlist_name = param_base_name + ".enable_pub_plugins";
+  auto parameters = impl_->node_->get_node_parameters_interface();
   std::vector<std::string> all_transport_names;
-  for (const auto & lookup_name : loader->getDeclaredClasses()) {
-    all_transport_names.emplace_back(erase_last_copy(lookup_name, "_pub"));
+  if (!parameters->has_parameter(allowlist_name) &&
+    parameters->get_parameter_overrides().count(allowlist_name) == 0)
+  {
+    auto index = impl::getTransportIndex(impl_->pluginLoader(), "_pub");
+    all_transport_names = index->transportNames();
+    for (const auto & lookup_name :
+      StaticTransportRegistry<NodeType>::instance().getPublisherLookupNames())
+    {
+      if (!index->hasLookupName(lookup_name)) {
+        all_transport_names.emplace_back(erase_last_copy(lookup_name, "_pub"));
+      }
+    }
   }
   try {
     allowlist_vec = impl_->node_->template declare_parameter<std::vector<std::string>>(
-      param_base_name + ".enable_pub_plugins", all_transport_names);
+      allowlist_name, all_transport_names);
   } catch (const rclcpp::exceptions::ParameterAlreadyDeclaredException &) {
     RCLCPP_DEBUG_STREAM(
       impl_->logger_, param_base_name << ".enable_pub_plugins" << " was previously declared"
@@ -173,12 +338,68 @@ void Publisher<NodeType>::initialise(
     allowlist.insert(allowlist_vec[i]);
   }
 
+  std::vector<std::string> lazy_vec;
+  double grace_period = 5.0;
+  try {
+    lazy_vec = impl_->node_->template declare_parameter<std::vector<std::string>>(
+      param_base_name + ".lazy_pub_plugins", std::vector<std::string>());
+  } catch (const rclcpp::exceptions::ParameterAlreadyDeclaredException &) {
+    RCLCPP_DEBUG_STREAM(
+      impl_->logger_, param_base_name << ".lazy_pub_plugins" << " was previously declared"
+    );
+    lazy_vec =
+      impl_->node_->get_parameter(
+      param_base_name +
+      ".lazy_pub_plugins").template get_value<std::vector<std::string>>();
+  }
+  try {
+    grace_period = impl_->node_->template declare_parameter<double>(
+      param_base_name + ".lazy_pub_plugins_grace_period", grace_period);
+  } catch (const rclcpp::exceptions::ParameterAlreadyDeclaredException &) {
+    RCLCPP_DEBUG_STREAM(
+      impl_->logger_,
+      param_base_name << ".lazy_pub_plugins_grace_period" << " was previously declared"
+    );
+    grace_period =
+      impl_->node_->get_parameter(
+      param_base_name +
+      ".lazy_pub_plugins_grace_period").template get_value<double>();
+  }
+  std::set<std::string> lazy(lazy_vec.begin(), lazy_vec.end());
+  impl_->custom_qos_ = custom_qos;
+  impl_->options_ = options;
+  impl_->lazy_grace_period_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(grace_period));
+
+  typename Impl::PluginList publishers;
   for (const auto & transport_name : allowlist) {
     const auto & lookup_name = transport_name + "_pub";
+    // The raw transport advertises the base topic itself, so it can never be dormant.
+    if (lazy.count(transport_name) && transport_name != "image_transport/raw") {
+      // Dormant plugins are woken by subscribers on the topic the plugin would advertise.
+      // Asking the plugin would load it, so assume the default "<base>/<transport>" unless
+      // "<base>.<transport>.lazy_topic" names another subtopic.
+      const std::string transport = transportBaseName(transport_name);
+      const std::string topic_name = param_base_name + "." + transport + ".lazy_topic";
+      std::string subtopic;
+      try {
+        subtopic = impl_->node_->template declare_parameter<std::string>(topic_name, transport);
+      } catch (const rclcpp::exceptions::ParameterAlreadyDeclaredException &) {
+        RCLCPP_DEBUG_STREAM(impl_->logger_, topic_name << " was previously declared");
+        subtopic = impl_->node_->get_parameter(topic_name).template get_value<std::string>();
+      }
+      typename Impl::LazyPlugin lazy_plugin;
+      lazy_plugin.lookup_name = lookup_name;
+      lazy_plugin.topic = image_topic + "/" + subtopic;
+      impl_->lazy_plugins_.push_back(lazy_plugin);
+      impl_->local_transports_.push_back(transportBaseName(transport_name));
+      continue;
+    }
     try {
-      auto pub = loader->createUniqueInstance(lookup_name);
+      auto pub = impl_->createPlugin(lookup_name);
       pub->advertise(impl_->node_, image_topic, custom_qos, options);
-      impl_->publishers_.push_back(std::move(pub));
+      publishers.push_back(std::move(pub));
+      impl_->local_transports_.push_back(transportBaseName(transport_name));
     } catch (const std::runtime_error & e) {
       RCLCPP_ERROR(
         impl_->logger_, "Failed to load plugin %s, error string: %s\n",
@@ -186,11 +407,31 @@ void Publisher<NodeType>::initialise(
     }
   }
 
-  if (impl_->publishers_.empty()) {
+  if (publishers.empty() && impl_->lazy_plugins_.empty()) {
     throw Exception(
             "No plugins found! Does `rospack plugins --attrib=plugin "
             "image_transport` find any packages?");
   }
+
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->setPublishers(std::move(publishers));
+  }
+
+  if (!impl_->lazy_plugins_.empty()) {
+    std::weak_ptr<Impl> weak_impl = impl_;
+    impl_->lazy_timer_ = impl_->node_->create_wall_timer(
+      std::chrono::milliseconds(250),
+      [weak_impl]() {
+        if (auto impl = weak_impl.lock()) {
+          impl->updateLazyPlugins();
+        }
+      });
+  }
+
+  // Let subscribers using the "auto" transport know this topic is served from this process.
+  impl::registerLocalPublisher(image_topic, impl_->local_transports_);
+  impl_->registered_ = true;
 }
 
 template<class NodeType>
@@ -217,7 +458,8 @@ void Publisher<NodeType>::publish(const sensor_msgs::msg::Image & message) const
     return;
   }
 
-  for (const auto & pub : impl_->publishers_) {
+  auto publishers = impl_->getPublishers();
+  for (const auto & pub : *publishers) {
     if (pub->getNumSubscribers() > 0) {
       pub->publish(message);
     }
@@ -234,7 +476,8 @@ void Publisher<NodeType>::publish(const sensor_msgs::msg::Image::ConstSharedPtr
     return;
   }
 
-  for (const auto & pub : impl_->publishers_) {
+  auto publishers = impl_->getPublishers();
+  for (const auto & pub : *publishers) {
     if (pub->getNumSubscribers() > 0) {
       pub->publishPtr(message);
     }
@@ -250,10 +493,11 @@ void Publisher<NodeType>::publish(sensor_msgs::msg::Image::UniquePtr message) co
     return;
   }
 
+  auto publishers = impl_->getPublishers();
   std::vector<std::shared_ptr<PublisherPlugin<NodeType>>> pubs_take_reference;
   std::optional<std::shared_ptr<PublisherPlugin<NodeType>>> pub_takes_ownership{std::nullopt};
 
-  for (const auto & pub : impl_->publishers_) {
+  for (const auto & pub : *publishers) {
     if (pub->getNumSubscribers() > 0) {
       if (pub->supportsUniquePtrPub() && !pub_takes_ownership.has_value()) {
         pub_takes_ownership = pub;
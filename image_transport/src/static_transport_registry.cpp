@@ -0,0 +1,139 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "image_transport/static_transport_registry.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "image_transport/publisher_plugin.hpp"
+#include "image_transport/subscriber_plugin.hpp"
+
+namespace image_transport
+{
+
+template<class NodeType>
+StaticTransportRegistry<NodeType> & StaticTransportRegistry<NodeType>::instance()
+{
+  // Leaked on purpose: registrations happen during static initialization and lookups
+  // may happen during static destruction.
+  static auto * registry = new StaticTransportRegistry();
+  return *registry;
+}
+
+template<class NodeType>
+void StaticTransportRegistry<NodeType>::registerPublisher(
+  const std::string & lookup_name, PublisherFactory factory)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  publishers_[lookup_name] = std::move(factory);
+}
+
+template<class NodeType>
+void StaticTransportRegistry<NodeType>::registerSubscriber(
+  const std::string & lookup_name, SubscriberFactory factory)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  subscribers_[lookup_name] = std::move(factory);
+}
+
+template<class NodeType>
+std::shared_ptr<PublisherPlugin<NodeType>> StaticTransportRegistry<NodeType>::createPublisher(
+  const std::string & lookup_name) const
+{
+  PublisherFactory factory;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = publishers_.find(lookup_name);
+    if (it == publishers_.end()) {
+      return nullptr;
+    }
+    factory = it->second;
+  }
+  return factory();
+}
+
+template<class NodeType>
+std::shared_ptr<SubscriberPlugin<NodeType>> StaticTransportRegistry<NodeType>::createSubscriber(
+  const std::string & lookup_name) const
+{
+  SubscriberFactory factory;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = subscribers_.find(lookup_name);
+    if (it == subscribers_.end()) {
+      return nullptr;
+    }
+    factory = it->second;
+  }
+  return factory();
+}
+
+template<class NodeType>
+bool StaticTransportRegistry<NodeType>::hasPublisher(const std::string & lookup_name) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return publishers_.count(lookup_name) > 0;
+}
+
+template<class NodeType>
+bool StaticTransportRegistry<NodeType>::hasSubscriber(const std::string & lookup_name) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return subscribers_.count(lookup_name) > 0;
+}
+
+template<class NodeType>
+std::vector<std::string> StaticTransportRegistry<NodeType>::getPublisherLookupNames() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::string> names;
+  for (const auto & entry : publishers_) {
+    names.push_back(entry.first);
+  }
+  return names;
+}
+
+template<class NodeType>
+std::vector<std::string> StaticTransportRegistry<NodeType>::getSubscriberLookupNames() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::string> names;
+  for (const auto & entry : subscribers_) {
+    names.push_back(entry.first);
+  }
+  return names;
+}
+
+}  // namespace image_transport
+
+template class image_transport::StaticTransportRegistry<rclcpp::Node>;
+template class image_transport::StaticTransportRegistry<rclcpp_lifecycle::LifecycleNode>;
@@ -0,0 +1,175 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "statistics_collector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "statistics_msgs/msg/statistic_data_point.hpp"
+#include "statistics_msgs/msg/statistic_data_type.hpp"
+
+namespace image_transport
+{
+namespace impl
+{
+
+namespace
+{
+
+size_t ageBucket(int64_t age_ns)
+{
+  if (age_ns < 2000) {
+    return 0;
+  }
+  uint64_t age_us = static_cast<uint64_t>(age_ns) / 1000;
+  size_t bucket = 0;
+  while (age_us >>= 1) {
+    ++bucket;
+  }
+  return std::min(bucket, SubscriberStatistics::kAgeHistogramBuckets - 1);
+}
+
+statistics_msgs::msg::StatisticDataPoint dataPoint(uint8_t type, double value)
+{
+  statistics_msgs::msg::StatisticDataPoint point;
+  point.data_type = type;
+  point.data = value;
+  return point;
+}
+
+statistics_msgs::msg::MetricsMessage summaryMessage(
+  const std::string & source, const std::string & name, const StatisticsSummary & summary)
+{
+  using statistics_msgs::msg::StatisticDataType;
+  statistics_msgs::msg::MetricsMessage msg;
+  msg.measurement_source_name = source;
+  msg.metrics_source = name;
+  msg.unit = "s";
+  msg.statistics.push_back(dataPoint(StatisticDataType::STATISTICS_DATA_TYPE_AVERAGE,
+    summary.count ? summary.mean : std::nan("")));
+  msg.statistics.push_back(dataPoint(StatisticDataType::STATISTICS_DATA_TYPE_MINIMUM,
+    summary.count ? summary.min : std::nan("")));
+  msg.statistics.push_back(dataPoint(StatisticDataType::STATISTICS_DATA_TYPE_MAXIMUM,
+    summary.count ? summary.max : std::nan("")));
+  msg.statistics.push_back(dataPoint(StatisticDataType::STATISTICS_DATA_TYPE_STDDEV,
+    summary.stddev()));
+  msg.statistics.push_back(dataPoint(StatisticDataType::STATISTICS_DATA_TYPE_SAMPLE_COUNT,
+    static_cast<double>(summary.count)));
+  return msg;
+}
+
+}  // namespace
+
+StatisticsCollector::StatisticsCollector(
+  const SubscriberStatisticsOptions & options, const rclcpp::Time & now)
+: options_(options),
+  window_start_(now)
+{
+}
+
+void StatisticsCollector::record(
+  const rclcpp::Time & stamp, const rclcpp::Time & received, double callback_duration)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++statistics_.received;
+
+  // Stamps and receive times can come from different clock types (e.g. a zero stamp),
+  // compare raw nanoseconds rather than letting rclcpp::Time throw.
+  int64_t age_ns = received.nanoseconds() - stamp.nanoseconds();
+  ++statistics_.age_histogram[ageBucket(age_ns)];
+  statistics_.age.add(static_cast<double>(age_ns) * 1e-9);
+  statistics_.callback_duration.add(callback_duration);
+
+  if (have_previous_) {
+    statistics_.inter_arrival.add(
+      static_cast<double>(received.nanoseconds() - previous_received_.nanoseconds()) * 1e-9);
+    int64_t gap_ns = stamp.nanoseconds() - previous_stamp_.nanoseconds();
+    if (options_.expected_rate > 0.0 && gap_ns > 0) {
+      auto periods = std::llround(static_cast<double>(gap_ns) * 1e-9 * options_.expected_rate);
+      if (periods > 1) {
+        statistics_.estimated_drops += static_cast<uint64_t>(periods - 1);
+      }
+    }
+  }
+  have_previous_ = true;
+  previous_stamp_ = stamp;
+  previous_received_ = received;
+}
+
+SubscriberStatistics StatisticsCollector::snapshot() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+void StatisticsCollector::reset(const rclcpp::Time & now)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  statistics_ = SubscriberStatistics();
+  window_start_ = now;
+  have_previous_ = false;
+}
+
+std::vector<statistics_msgs::msg::MetricsMessage> StatisticsCollector::toMetricsMessages(
+  const std::string & source, const rclcpp::Time & now) const
+{
+  using statistics_msgs::msg::StatisticDataType;
+  SubscriberStatistics statistics;
+  rclcpp::Time window_start;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics = statistics_;
+    window_start = window_start_;
+  }
+
+  std::vector<statistics_msgs::msg::MetricsMessage> messages;
+  messages.push_back(summaryMessage(source, "message_age", statistics.age));
+  messages.push_back(summaryMessage(source, "callback_duration", statistics.callback_duration));
+  messages.push_back(summaryMessage(source, "inter_arrival", statistics.inter_arrival));
+
+  statistics_msgs::msg::MetricsMessage drops;
+  drops.measurement_source_name = source;
+  drops.metrics_source = "estimated_drops";
+  drops.unit = "count";
+  drops.statistics.push_back(dataPoint(StatisticDataType::STATISTICS_DATA_TYPE_SAMPLE_COUNT,
+    static_cast<double>(statistics.estimated_drops)));
+  messages.push_back(drops);
+
+  for (auto & msg : messages) {
+    msg.window_start = window_start;
+    msg.window_stop = now;
+  }
+  return messages;
+}
+
+}  // namespace impl
+}  // namespace image_transport
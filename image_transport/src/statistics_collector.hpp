@@ -0,0 +1,91 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef STATISTICS_COLLECTOR_HPP_
+#define STATISTICS_COLLECTOR_HPP_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rclcpp/time.hpp"
+#include "statistics_msgs/msg/metrics_message.hpp"
+
+#include "image_transport/subscriber_statistics.hpp"
+
+namespace image_transport
+{
+namespace impl
+{
+
+/**
+ * \brief Accumulates the SubscriberStatistics of one Subscriber. Thread safe.
+ */
+class StatisticsCollector
+{
+public:
+  StatisticsCollector(const SubscriberStatisticsOptions & options, const rclcpp::Time & now);
+
+  /**
+   * \brief Record one delivered image.
+   *
+   * \param stamp header.stamp of the image.
+   * \param received Node clock time at which the image reached the Subscriber.
+   * \param callback_duration Time spent in the user callback, in seconds.
+   */
+  void record(const rclcpp::Time & stamp, const rclcpp::Time & received, double callback_duration);
+
+  SubscriberStatistics snapshot() const;
+
+  void reset(const rclcpp::Time & now);
+
+  /**
+   * \brief Convert the current statistics to one MetricsMessage per measurement, covering
+   * the window from the last reset to \a now.
+   */
+  std::vector<statistics_msgs::msg::MetricsMessage> toMetricsMessages(
+    const std::string & source, const rclcpp::Time & now) const;
+
+  const SubscriberStatisticsOptions & options() const {return options_;}
+
+private:
+  const SubscriberStatisticsOptions options_;
+
+  mutable std::mutex mutex_;
+  SubscriberStatistics statistics_;
+  rclcpp::Time window_start_;
+  bool have_previous_ = false;
+  rclcpp::Time previous_stamp_;
+  rclcpp::Time previous_received_;
+};
+
+}  // namespace impl
+}  // namespace image_transport
+
+#endif  // STATISTICS_COLLECTOR_HPP_
@@ -28,30 +28,44 @@
 
 #include "image_transport/subscriber.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "rclcpp/create_publisher.hpp"
 #include "rclcpp/expand_topic_or_service_name.hpp"
 #include "rclcpp/logging.hpp"
 
 #include "sensor_msgs/msg/image.hpp"
+#include "statistics_msgs/msg/metrics_message.hpp"
 
 #include "pluginlib/class_loader.hpp"
 
+#include "image_transport/static_transport_registry.hpp"
 #include "image_transport/subscriber_plugin.hpp"
 
+#include "default_loaders.hpp"
+#include "isolated_callback_group.hpp"
+#include "local_publishers.hpp"
+#include "statistics_collector.hpp"
+#include "transport_index.hpp"
+
 namespace image_transport
 {
 
 template<class NodeType>
-struct Subscriber<NodeType>::Impl
+struct Subscriber<NodeType>::Impl : public std::enable_shared_from_this<Impl>
 {
   Impl(NodeType * node, SubLoaderPtr<NodeType> loader)
   : node_(node),
     logger_(node->get_logger()),
     loader_(loader),
-    unsubscribed_(false)
+    unsubscribed_(false),
+    clock_(node->get_clock())
   {
   }
 
@@ -59,7 +73,8 @@ struct Subscriber<NodeType>::Impl
   : node_(node),
     logger_(node->get_logger()),
     loader_(loader),
-    unsubscribed_(false)
+    unsubscribed_(false),
+    clock_(node->get_clock())
   {
   }
 
@@ -75,11 +90,174 @@ struct Subscriber<NodeType>::Impl
 
   void shutdown()
   {
+    if (auto_select_timer_) {
+      auto_select_timer_->cancel();
+    }
+    disableStatistics();
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!unsubscribed_) {
       unsubscribed_ = true;
       if (subscriber_) {
         subscriber_->shutdown();
       }
+      if (isolated_group_) {
+        isolated_group_->stop();
+      }
+    }
+  }
+
+  void dispatch(const Callback & callback, const sensor_msgs::msg::Image::ConstSharedPtr & msg)
+  {
+    auto statistics = std::atomic_load(&statistics_);
+    if (!statistics) {
+      callback(msg);
+      return;
+    }
+    rclcpp::Time received = clock_->now();
+    auto start = std::chrono::steady_clock::now();
+    callback(msg);
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    statistics->record(
+      rclcpp::Time(msg->header.stamp, received.get_clock_type()), received, duration.count());
+  }
+
+  void enableStatistics(const SubscriberStatisticsOptions & options)
+  {
+    disableStatistics();
+    auto statistics = std::make_shared<impl::StatisticsCollector>(options, clock_->now());
+    if (!options.topic.empty()) {
+      // Not node_->create_publisher(), which gives lifecycle nodes an inactive publisher.
+      statistics_pub_ = rclcpp::create_publisher<statistics_msgs::msg::MetricsMessage>(
+        *node_, options.topic, rclcpp::QoS(10));
+      // The timer owns what it publishes and only holds the Impl weakly, so a callback
+      // that is already running survives disableStatistics() and the Subscriber itself.
+      std::weak_ptr<Impl> weak_impl = this->weak_from_this();
+      auto publisher = statistics_pub_;
+      statistics_timer_ = node_->create_wall_timer(
+        options.publish_period,
+        [weak_impl, statistics, publisher]() {
+          if (auto impl = weak_impl.lock()) {
+            impl->publishStatistics(*statistics, *publisher);
+          }
+        });
+    }
+    std::atomic_store(&statistics_, statistics);
+  }
+
+  void disableStatistics()
+  {
+    if (statistics_timer_) {
+      statistics_timer_->cancel();
+      statistics_timer_.reset();
+    }
+    statistics_pub_.reset();
+    std::atomic_store(&statistics_, std::shared_ptr<impl::StatisticsCollector>());
+  }
+
+  void publishStatistics(
+    impl::StatisticsCollector & statistics,
+    rclcpp::Publisher<statistics_msgs::msg::MetricsMessage> & publisher) const
+  {
+    for (const auto & msg : statistics.toMetricsMessages(base_topic_, clock_->now())) {
+      publisher.publish(msg);
+    }
+  }
+
+  bool isDeclared(const std::string & lookup_name) const
+  {
+    return StaticTransportRegistry<NodeType>::instance().hasSubscriber(lookup_name) ||
+           impl::getTransportIndex(pluginLoader(), "_sub")->hasLookupName(lookup_name);
+  }
+
+  /// The loader given on construction, or the default one, which is only built on demand.
+  SubLoaderPtr<NodeType> pluginLoader() const
+  {
+    return loader_ ? loader_ : impl::getDefaultSubLoader<NodeType>();
+  }
+
+  std::shared_ptr<SubscriberPlugin<NodeType>> getSubscriber() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscriber_;
+  }
+
+  /**
+   * Pick the transport an "auto" subscriber should use right now: raw when a Publisher in
+   * this process offers it, the configured remote transport when some publisher offers
+   * it, and raw otherwise.
+   */
+  std::string selectAutoTransport() const
+  {
+    if (impl::hasLocalPublisher(base_topic_, "raw")) {
+      return "raw";
+    }
+    if (remote_transport_ != "raw" &&
+      node_->count_publishers(base_topic_ + "/" + remote_transport_) > 0)
+    {
+      return remote_transport_;
+    }
+    return "raw";
+  }
+
+  void subscribeWith(const std::string & transport)
+  {
+    std::string lookup_name = SubscriberPlugin<NodeType>::getLookupName(
+      transport + transport_suffix_);
+    // Statically linked transports take precedence over pluginlib.
+    std::shared_ptr<SubscriberPlugin<NodeType>> subscriber =
+      StaticTransportRegistry<NodeType>::instance().createSubscriber(lookup_name);
+    if (!subscriber) {
+      try {
+        subscriber = pluginLoader()->createSharedInstance(lookup_name);
+      } catch (pluginlib::PluginlibException & e) {
+        throw TransportLoadException(lookup_name, e.what());
+      }
+    }
+
+    RCLCPP_DEBUG(logger_, "Subscribing to: %s\n", base_topic_.c_str());
+    subscriber->subscribe(node_, base_topic_, callback_, custom_qos_, options_);
+
+    std::shared_ptr<SubscriberPlugin<NodeType>> previous;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (unsubscribed_) {
+        // Shut down while subscribing; drop the new subscription instead.
+        previous = std::move(subscriber);
+      } else {
+        previous = std::move(subscriber_);
+        subscriber_ = std::move(subscriber);
+        lookup_name_ = lookup_name;
+        selected_transport_ = transport;
+      }
+    }
+    if (previous) {
+      previous->shutdown();
+    }
+  }
+
+  void reselectAutoTransport()
+  {
+    std::string selected;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (unsubscribed_) {
+        return;
+      }
+      selected = selected_transport_;
+    }
+    std::string transport = selectAutoTransport();
+    if (transport == selected) {
+      return;
+    }
+    RCLCPP_INFO(
+      logger_, "[image_transport] Switching '%s' from transport '%s' to '%s'",
+      base_topic_.c_str(), selected.c_str(), transport.c_str());
+    try {
+      subscribeWith(transport);
+    } catch (const TransportLoadException & e) {
+      RCLCPP_ERROR(
+        logger_, "[image_transport] Failed to switch '%s' to transport '%s': %s",
+        base_topic_.c_str(), transport.c_str(), e.what());
     }
   }
 
@@ -90,6 +268,25 @@ struct Subscriber<NodeType>::Impl
   std::shared_ptr<SubscriberPlugin<NodeType>> subscriber_;
   bool unsubscribed_;
   // double constructed_;
+
+  // State needed to resubscribe when the "auto" transport changes its choice.
+  mutable std::mutex mutex_;
+  std::string base_topic_;
+  Callback callback_;
+  rmw_qos_profile_t custom_qos_;
+  rclcpp::SubscriptionOptions options_;
+  std::string transport_suffix_;
+  std::string remote_transport_;
+  std::string selected_transport_;
+  rclcpp::TimerBase::SharedPtr auto_select_timer_;
+
+  std::shared_ptr<impl::IsolatedCallbackGroup> isolated_group_;
+
+  // Optional statistics, accessed atomically from the subscription callback.
+  std::shared_ptr<impl::StatisticsCollector> statistics_;
+  const rclcpp::Clock::SharedPtr clock_;
+  rclcpp::Publisher<statistics_msgs::msg::MetricsMessage>::SharedPtr statistics_pub_;
+  rclcpp::TimerBase::SharedPtr statistics_timer_;
 };
 
 template<class NodeType>
@@ -100,10 +297,11 @@ Subscriber<NodeType>::Subscriber(
   SubLoaderPtr<NodeType> loader,
   const std::string & transport,
   rmw_qos_profile_t custom_qos,
-  rclcpp::SubscriptionOptions options)
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 : impl_(std::make_shared<Impl>(node, loader))
 {
-  initialise(base_topic, callback, transport, custom_qos, options);
+  initialise(base_topic, callback, transport, custom_qos, options, isolation);
 }
 
 template<class NodeType>
@@ -114,10 +312,11 @@ Subscriber<NodeType>::Subscriber(
   SubLoaderPtr<NodeType> loader,
   const std::string & transport,
   rmw_qos_profile_t custom_qos,
-  rclcpp::SubscriptionOptions options)
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 : impl_(std::make_shared<Impl>(node, loader))
 {
-  initialise(base_topic, callback, transport, custom_qos, options);
+  initialise(base_topic, callback, transport, custom_qos, options, isolation);
 }
 
 template<class NodeType>
@@ -126,17 +325,39 @@ void Subscriber<NodeType>::initialise(
   const Callback & callback,
   const std::string & transport,
   rmw_qos_profile_t custom_qos,
-  rclcpp::SubscriptionOptions options)
+  rclcpp::SubscriptionOptions options,
+  const CallbackIsolation & isolation)
 {
   if (!impl_) {
     throw std::runtime_error("impl is not constructed!");
   }
-  // Load the plugin for the chosen transport.
-  impl_->lookup_name_ = SubscriberPlugin<NodeType>::getLookupName(transport);
-  try {
-    impl_->subscriber_ = impl_->loader_->createSharedInstance(impl_->lookup_name_);
-  } catch (pluginlib::PluginlibException & e) {
-    throw TransportLoadException(impl_->lookup_name_, e.what());
+  if (isolation.enabled()) {
+    impl_->isolated_group_ = std::make_shared<impl::IsolatedCallbackGroup>(
+      impl_->node_->get_node_base_interface(), isolation, impl_->logger_);
+    options.callback_group = impl_->isolated_group_->getCallbackGroup();
+  }
+  // Route the user callback through the Impl so statistics can be enabled at any time.
+  // Messages still queued in the executor when the Subscriber goes away are dropped.
+  std::weak_ptr<Impl> weak_impl = impl_;
+  impl_->callback_ =
+    [weak_impl, callback](const sensor_msgs::msg::Image::ConstSharedPtr & msg) {
+      if (auto impl = weak_impl.lock()) {
+        impl->dispatch(callback, msg);
+      }
+    };
+  impl_->custom_qos_ = custom_qos;
+  impl_->options_ = options;
+
+  // Lifecycle nodes load the "<transport>_lifecycle" flavour of each plugin.
+  std::string base_transport = transport;
+  const std::string lifecycle_suffix = "_lifecycle";
+  if (transport.size() > lifecycle_suffix.size() &&
+    transport.compare(
+      transport.size() - lifecycle_suffix.size(), lifecycle_suffix.size(),
+      lifecycle_suffix) == 0)
+  {
+    base_transport = transport.substr(0, transport.size() - lifecycle_suffix.size());
+    impl_->transport_suffix_ = lifecycle_suffix;
   }
 
   // Try to catch if user passed in a transport-specific topic as base_topic.
@@ -144,12 +365,18 @@ void Subscriber<NodeType>::initialise(
   // std::string clean_topic = ros::names::clean(base_topic);
   std::string clean_topic = base_topic;
 
+  // Checking against pluginlib would read every plugin manifest, which a subscriber to a
+  // statically registered transport otherwise never does.
+  const bool static_transport = StaticTransportRegistry<NodeType>::instance().hasSubscriber(
+    SubscriberPlugin<NodeType>::getLookupName(base_transport + impl_->transport_suffix_));
   size_t found = clean_topic.rfind('/');
   if (found != std::string::npos) {
     std::string transport = clean_topic.substr(found + 1);
     std::string plugin_name = SubscriberPlugin<NodeType>::getLookupName(transport);
-    std::vector<std::string> plugins = impl_->loader_->getDeclaredClasses();
-    if (std::find(plugins.begin(), plugins.end(), plugin_name) != plugins.end()) {
+    if (static_transport ?
+      StaticTransportRegistry<NodeType>::instance().hasSubscriber(plugin_name) :
+      impl_->isDeclared(plugin_name))
+    {
       std::string real_base_topic = clean_topic.substr(0, found);
 
       RCLCPP_WARN(
@@ -163,32 +390,112 @@ void Subscriber<NodeType>::initialise(
     }
   }
 
-  // Tell plugin to subscribe.
-  RCLCPP_DEBUG(impl_->logger_, "Subscribing to: %s\n", base_topic.c_str());
-  impl_->subscriber_->subscribe(impl_->node_, base_topic, callback, custom_qos, options);
+  if (base_transport != "auto") {
+    // Load the plugin for the chosen transport and tell it to subscribe.
+    impl_->base_topic_ = base_topic;
+    impl_->subscribeWith(base_transport);
+    return;
+  }
+
+  // The "auto" transport needs the resolved topic to match it against local publishers
+  // and to count publishers on the transport-specific topics.
+  impl_->base_topic_ = rclcpp::expand_topic_or_service_name(
+    base_topic, impl_->node_->get_name(), impl_->node_->get_namespace());
+  std::string param_base_name =
+    impl_->base_topic_.substr(strlen(impl_->node_->get_namespace()));
+  std::replace(param_base_name.begin(), param_base_name.end(), '/', '.');
+  if (param_base_name.front() == '.') {
+    param_base_name = param_base_name.substr(1);
+  }
+  try {
+    impl_->remote_transport_ = impl_->node_->template declare_parameter<std::string>(
+      param_base_name + ".auto_remote_transport", "compressed");
+  } catch (const rclcpp::exceptions::ParameterAlreadyDeclaredException &) {
+    RCLCPP_DEBUG_STREAM(
+      impl_->logger_, param_base_name << ".auto_remote_transport" << " was previously declared"
+    );
+    impl_->remote_transport_ =
+      impl_->node_->get_parameter(
+      param_base_name +
+      ".auto_remote_transport").template get_value<std::string>();
+  }
+  std::string remote_lookup_name = SubscriberPlugin<NodeType>::getLookupName(
+    impl_->remote_transport_ + impl_->transport_suffix_);
+  if (!impl_->isDeclared(remote_lookup_name)) {
+    RCLCPP_WARN(
+      impl_->logger_,
+      "[image_transport] Transport '%s' configured for remote publishers of '%s' is not "
+      "available, falling back to 'raw'",
+      impl_->remote_transport_.c_str(), impl_->base_topic_.c_str());
+    impl_->remote_transport_ = "raw";
+  }
+
+  impl_->subscribeWith(impl_->selectAutoTransport());
+
+  // Publishers come and go, so keep checking whether a better transport is available.
+  // The timer holds the Impl weakly, so a pending callback does not outlive the Subscriber.
+  impl_->auto_select_timer_ = impl_->node_->create_wall_timer(
+    std::chrono::seconds(1),
+    [weak_impl]() {
+      if (auto impl = weak_impl.lock()) {
+        impl->reselectAutoTransport();
+      }
+    });
 }
 
 template<class NodeType>
 std::string Subscriber<NodeType>::getTopic() const
 {
-  if (impl_) {return impl_->subscriber_->getTopic();}
+  if (impl_) {return impl_->getSubscriber()->getTopic();}
   return std::string();
 }
 
 template<class NodeType>
 size_t Subscriber<NodeType>::getNumPublishers() const
 {
-  if (impl_) {return impl_->subscriber_->getNumPublishers();}
+  if (impl_) {return impl_->getSubscriber()->getNumPublishers();}
   return 0;
 }
 
 template<class NodeType>
 std::string Subscriber<NodeType>::getTransport() const
 {
-  if (impl_) {return impl_->subscriber_->getTransportName();}
+  if (impl_) {return impl_->getSubscriber()->getTransportName();}
   return std::string();
 }
 
+template<class NodeType>
+void Subscriber<NodeType>::enableStatistics(const SubscriberStatisticsOptions & options)
+{
+  if (impl_) {impl_->enableStatistics(options);}
+}
+
+template<class NodeType>
+void Subscriber<NodeType>::disableStatistics()
+{
+  if (impl_) {impl_->disableStatistics();}
+}
+
+template<class NodeType>
+SubscriberStatistics Subscriber<NodeType>::getStatistics() const
+{
+  if (impl_) {
+    auto statistics = std::atomic_load(&impl_->statistics_);
+    if (statistics) {return statistics->snapshot();}
+  }
+  return SubscriberStatistics();
+}
+
+template<class NodeType>
+void Subscriber<NodeType>::resetStatistics()
+{
+  if (!impl_) {
+    return;
+  }
+  auto statistics = std::atomic_load(&impl_->statistics_);
+  if (statistics) {statistics->reset(impl_->clock_->now());}
+}
+
 template<class NodeType>
 void Subscriber<NodeType>::shutdown()
 {
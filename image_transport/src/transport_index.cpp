@@ -0,0 +1,64 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "transport_index.hpp"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "image_transport/camera_common.hpp"
+
+namespace image_transport
+{
+namespace impl
+{
+
+TransportIndex::TransportIndex(std::vector<std::string> lookup_names, const std::string & suffix)
+: lookup_names_(std::move(lookup_names))
+{
+  transport_names_.reserve(lookup_names_.size());
+  sorted_lookup_names_.reserve(lookup_names_.size());
+  for (const auto & lookup_name : lookup_names_) {
+    transport_names_.push_back(erase_last_copy(lookup_name, suffix));
+    sorted_lookup_names_.push_back(lookup_name);
+  }
+  // The views point into lookup_names_, which is never modified after this.
+  std::sort(sorted_lookup_names_.begin(), sorted_lookup_names_.end());
+}
+
+bool TransportIndex::hasLookupName(std::string_view lookup_name) const
+{
+  return std::binary_search(
+    sorted_lookup_names_.begin(), sorted_lookup_names_.end(), lookup_name);
+}
+
+}  // namespace impl
+}  // namespace image_transport
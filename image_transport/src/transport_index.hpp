@@ -0,0 +1,96 @@
+// Copyright (c) 2009, Willow Garage, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef TRANSPORT_INDEX_HPP_
+#define TRANSPORT_INDEX_HPP_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace image_transport
+{
+namespace impl
+{
+
+/**
+ * \brief Immutable index of the plugins declared to one pluginlib loader.
+ *
+ * Holds the sorted lookup names (e.g. "image_transport/raw_sub") and the matching
+ * transport names with the "_pub"/"_sub" suffix removed (e.g. "image_transport/raw").
+ * Being immutable, an index can be shared between threads without locking.
+ */
+class TransportIndex
+{
+public:
+  TransportIndex(std::vector<std::string> lookup_names, const std::string & suffix);
+
+  // Copying would leave the sorted views pointing into the source object.
+  TransportIndex(const TransportIndex &) = delete;
+  TransportIndex & operator=(const TransportIndex &) = delete;
+
+  /// Lookup names in the order pluginlib declared them.
+  const std::vector<std::string> & lookupNames() const {return lookup_names_;}
+
+  /// Transport names, in the same order as lookupNames().
+  const std::vector<std::string> & transportNames() const {return transport_names_;}
+
+  /// Returns true if \a lookup_name was declared, in O(log n) without allocating.
+  bool hasLookupName(std::string_view lookup_name) const;
+
+private:
+  std::vector<std::string> lookup_names_;
+  std::vector<std::string> transport_names_;
+  std::vector<std::string_view> sorted_lookup_names_;
+};
+
+/**
+ * \brief Returns the index for \a loader, building it with \a declared_classes on first use.
+ *
+ * Indexes are cached process-wide, keyed by loader, and dropped once their loader is
+ * destroyed. Defined in image_transport.cpp, which owns the default loaders.
+ */
+std::shared_ptr<const TransportIndex> getTransportIndex(
+  const std::shared_ptr<const void> & loader,
+  const std::function<std::vector<std::string>()> & declared_classes,
+  const std::string & suffix);
+
+template<class Loader>
+std::shared_ptr<const TransportIndex> getTransportIndex(
+  const std::shared_ptr<Loader> & loader, const std::string & suffix)
+{
+  return getTransportIndex(
+    loader, [&loader]() {return loader->getDeclaredClasses();}, suffix);
+}
+
+}  // namespace impl
+}  // namespace image_transport
+
+#endif  // TRANSPORT_INDEX_HPP_
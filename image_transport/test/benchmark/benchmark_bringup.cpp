@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Open Source Robotics Foundation, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pluginlib/class_loader.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "image_transport/image_transport.hpp"
+#include "image_transport/subscriber_plugin.hpp"
+
+// Bringup costs of transport discovery. BM_DeclaredClassesScan is the work every
+// Subscriber used to do on creation; the other benchmarks go through the cached
+// transport index.
+
+static void BM_DeclaredClassesScan(benchmark::State & state)
+{
+  auto loader = std::make_shared<image_transport::SubLoader<rclcpp::Node>>(
+    "image_transport", "image_transport::SubscriberPlugin<rclcpp::Node>");
+  const std::string lookup_name = "image_transport/image_sub";
+  for (auto _ : state) {
+    std::vector<std::string> plugins = loader->getDeclaredClasses();
+    bool found = std::find(plugins.begin(), plugins.end(), lookup_name) != plugins.end();
+    benchmark::DoNotOptimize(found);
+  }
+}
+BENCHMARK(BM_DeclaredClassesScan);
+
+static void BM_GetDeclaredTransports(benchmark::State & state)
+{
+  for (auto _ : state) {
+    auto transports = image_transport::getDeclaredTransports();
+    benchmark::DoNotOptimize(transports);
+  }
+}
+BENCHMARK(BM_GetDeclaredTransports);
+
+static void BM_SubscriptionBringup(benchmark::State & state)
+{
+  // main() comes from ament_add_google_benchmark(), so rclcpp is brought up here. The
+  // default context shuts itself down at exit.
+  if (!rclcpp::ok()) {
+    rclcpp::init(0, nullptr);
+  }
+  auto node = rclcpp::Node::make_shared("benchmark_bringup");
+  std::function<void(const sensor_msgs::msg::Image::ConstSharedPtr &)> fcn =
+    [](const auto & msg) {(void)msg;};
+  std::vector<image_transport::Subscriber<rclcpp::Node>> subscribers;
+  subscribers.reserve(state.range(0));
+
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      subscribers.push_back(
+        image_transport::create_subscription(
+          node, "camera_" + std::to_string(i) + "/image", fcn, "raw"));
+    }
+    state.PauseTiming();
+    subscribers.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SubscriptionBringup)->Arg(10)->Arg(100);
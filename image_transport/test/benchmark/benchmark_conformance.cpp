@@ -0,0 +1,109 @@
+// Copyright (c) 2024 Open Source Robotics Foundation, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Benchmarks a transport's encoder on the conformance corpus, see
+// image_transport/testing/conformance.hpp.
+//
+// BM_Encode/<transport>/<image> times one publish through an EncodeHarness, which has nothing
+// subscribed, so it measures the transport's encoding alone. The "allocs" counter is the
+// number of heap allocations per encode.
+//
+// The transports come from the comma separated IMAGE_TRANSPORT_CONFORMANCE_TRANSPORTS
+// environment variable, "raw" by default. Any installed transport plugin can be measured
+// with this executable:
+//   IMAGE_TRANSPORT_CONFORMANCE_TRANSPORTS=raw,compressed image_transport-benchmark_conformance
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+
+#include "image_transport/testing/allocation_counter.hpp"
+#include "image_transport/testing/conformance.hpp"
+
+IMAGE_TRANSPORT_TESTING_COUNT_ALLOCATIONS()
+
+namespace
+{
+
+void BM_Encode(benchmark::State & state, const std::string & transport, size_t image_index)
+{
+  if (!rclcpp::ok()) {
+    rclcpp::init(0, nullptr);
+  }
+  const auto corpus = image_transport::testing::standardCorpus();
+  const sensor_msgs::msg::Image & image = corpus[image_index].image;
+
+  std::unique_ptr<image_transport::testing::EncodeHarness> encoder;
+  try {
+    encoder = std::make_unique<image_transport::testing::EncodeHarness>(transport);
+  } catch (const std::exception & e) {
+    state.SkipWithError(e.what());
+    return;
+  }
+
+  auto & counter = image_transport::testing::allocationCounter();
+  uint64_t allocations = 0;
+  for (auto _ : state) {
+    const uint64_t before = counter.load(std::memory_order_relaxed);
+    encoder->encode(image);
+    allocations += counter.load(std::memory_order_relaxed) - before;
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(image.data.size()));
+  state.counters["allocs"] = benchmark::Counter(
+    static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+[[maybe_unused]] const bool kRegistered = []() {
+    const char * env = std::getenv("IMAGE_TRANSPORT_CONFORMANCE_TRANSPORTS");
+    std::istringstream transports(env && *env ? env : "raw");
+    // Only the names are needed here, the benchmarks build the full size corpus.
+    const auto corpus = image_transport::testing::standardCorpus(1, 1);
+    std::string transport;
+    while (std::getline(transports, transport, ',')) {
+      if (transport.empty()) {
+        continue;
+      }
+      for (size_t i = 0; i < corpus.size(); ++i) {
+        benchmark::RegisterBenchmark(
+          ("BM_Encode/" + transport + "/" + corpus[i].name).c_str(), BM_Encode, transport, i);
+      }
+    }
+    return true;
+  }();
+
+}  // namespace
@@ -0,0 +1,342 @@
+// Copyright (c) 2024 Open Source Robotics Foundation, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Benchmarks for the image_transport hot paths: the Publisher::publish overloads,
+// CameraPublisher::publish, subscription delivery and CameraSubscriber pairing.
+//
+// Benchmark arguments are {image size, active plugins, intra-process}:
+// - image size indexes kImageSizes, VGA to 8K rgb8;
+// - active plugins is the number of enabled transports with a subscriber, raw plus up to
+//   four statically registered copying transports standing in for real encoders;
+// - intra-process selects intra-process delivery, otherwise messages go through the RMW.
+//
+// The full matrix of 30 configurations per benchmark takes several minutes. Unless the
+// package is configured with -DIMAGE_TRANSPORT_FULL_BENCHMARKS=ON, only a smoke subset
+// (VGA, one or all plugins) is registered, which is what CTest runs.
+//
+// Results can be compared across commits with
+//   image_transport_benchmarks --benchmark_out=results.json --benchmark_out_format=json
+// and google-benchmark's compare.py.
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/image_encodings.hpp"
+
+#include "image_transport/image_transport.hpp"
+#include "image_transport/simple_publisher_plugin.hpp"
+#include "image_transport/static_transport_registry.hpp"
+
+namespace
+{
+
+struct ImageSize
+{
+  const char * name;
+  uint32_t width;
+  uint32_t height;
+};
+
+constexpr std::array<ImageSize, 5> kImageSizes{{
+  {"VGA", 640, 480},
+  {"HD", 1280, 720},
+  {"FHD", 1920, 1080},
+  {"4K", 3840, 2160},
+  {"8K", 7680, 4320},
+}};
+
+constexpr int kMaxPlugins = 5;
+
+/**
+ * Stand-in for an encoding transport: republishes the image on "<base_topic>/bench_<N>",
+ * which costs one full copy of the image data per publish.
+ */
+template<int N>
+class CopyingPublisher : public image_transport::SimplePublisherPlugin<sensor_msgs::msg::Image>
+{
+public:
+  std::string getTransportName() const override
+  {
+    return "bench_" + std::to_string(N);
+  }
+
+protected:
+  void publish(const sensor_msgs::msg::Image & message, const PublisherT & publisher) const
+  override
+  {
+    publisher->publish(message);
+  }
+};
+
+}  // namespace
+
+IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(
+  rclcpp::Node, CopyingPublisher<1>, "image_transport/bench_1_pub")
+IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(
+  rclcpp::Node, CopyingPublisher<2>, "image_transport/bench_2_pub")
+IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(
+  rclcpp::Node, CopyingPublisher<3>, "image_transport/bench_3_pub")
+IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(
+  rclcpp::Node, CopyingPublisher<4>, "image_transport/bench_4_pub")
+
+namespace
+{
+
+sensor_msgs::msg::Image makeImage(const ImageSize & size)
+{
+  sensor_msgs::msg::Image image;
+  image.width = size.width;
+  image.height = size.height;
+  image.encoding = sensor_msgs::image_encodings::RGB8;
+  image.step = size.width * 3;
+  image.data.assign(static_cast<size_t>(image.step) * image.height, 0x5a);
+  return image;
+}
+
+/**
+ * A node publishing on "camera/image" with a given number of active plugins, each with
+ * one subscriber on the same node.
+ */
+class BenchmarkGraph
+{
+public:
+  BenchmarkGraph(const benchmark::State & state, bool camera)
+  : size_(kImageSizes.at(state.range(0))),
+    num_plugins_(static_cast<int>(state.range(1)))
+  {
+    // main() comes from ament_add_google_benchmark(), so rclcpp is brought up here. The
+    // default context shuts itself down at exit.
+    if (!rclcpp::ok()) {
+      rclcpp::init(0, nullptr);
+    }
+    auto options = rclcpp::NodeOptions().use_intra_process_comms(state.range(2) != 0);
+    node_ = rclcpp::Node::make_shared("image_transport_benchmark", options);
+
+    std::vector<std::string> plugins{"image_transport/raw"};
+    for (int i = 1; i < num_plugins_; ++i) {
+      plugins.push_back("image_transport/bench_" + std::to_string(i));
+    }
+    node_->declare_parameter("camera.image.enable_pub_plugins", plugins);
+
+    // Keep only the latest image so unspun subscriptions do not hold on to memory.
+    auto qos = rmw_qos_profile_default;
+    qos.depth = 1;
+    if (camera) {
+      camera_pub_ = image_transport::create_camera_publisher(node_, "camera/image", qos);
+    } else {
+      pub_ = image_transport::create_publisher(node_, "camera/image", qos);
+    }
+    for (int i = 1; i < num_plugins_; ++i) {
+      subscriptions_.push_back(
+        node_->create_subscription<sensor_msgs::msg::Image>(
+          "camera/image/bench_" + std::to_string(i), rclcpp::QoS(1),
+          [this](sensor_msgs::msg::Image::ConstSharedPtr) {++plugin_received_;}));
+    }
+    executor_.add_node(node_);
+  }
+
+  void setCounters(benchmark::State & state) const
+  {
+    const auto bytes = static_cast<int64_t>(size_.width) * size_.height * 3;
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes);
+    state.SetLabel(
+      std::string(size_.name) + "/" + std::to_string(num_plugins_) + "_plugins/" +
+      (node_->get_node_options().use_intra_process_comms() ? "intra" : "inter"));
+  }
+
+  ImageSize size_;
+  int num_plugins_;
+  rclcpp::Node::SharedPtr node_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  image_transport::Publisher<rclcpp::Node> pub_;
+  image_transport::CameraPublisher<rclcpp::Node> camera_pub_;
+  std::vector<rclcpp::SubscriptionBase::SharedPtr> subscriptions_;
+  std::atomic<int> plugin_received_{0};
+};
+
+void benchmarkArguments(benchmark::internal::Benchmark * benchmark)
+{
+  benchmark->ArgNames({"size", "plugins", "intra"});
+#ifdef IMAGE_TRANSPORT_FULL_BENCHMARKS
+  const int64_t num_sizes = static_cast<int64_t>(kImageSizes.size());
+  const std::vector<int64_t> num_plugins{1, 3, kMaxPlugins};
+#else
+  const int64_t num_sizes = 1;
+  const std::vector<int64_t> num_plugins{1, kMaxPlugins};
+#endif
+  for (int64_t size = 0; size < num_sizes; ++size) {
+    for (int64_t plugins : num_plugins) {
+      for (int64_t intra : {0, 1}) {
+        benchmark->Args({size, plugins, intra});
+      }
+    }
+  }
+  benchmark->Unit(benchmark::kMicrosecond);
+}
+
+/**
+ * Spin until \a done returns true or a second passed, returns false on timeout.
+ */
+template<class Predicate>
+bool spinUntil(rclcpp::Executor & executor, Predicate done)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    executor.spin_some(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+}  // namespace
+
+static void BM_PublishConstRef(benchmark::State & state)
+{
+  BenchmarkGraph graph(state, false);
+  auto image = makeImage(graph.size_);
+  // A raw subscriber makes the raw plugin active as well.
+  auto sub = image_transport::create_subscription(
+    graph.node_, "camera/image", [](const sensor_msgs::msg::Image::ConstSharedPtr &) {}, "raw",
+    rmw_qos_profile_sensor_data);
+  for (auto _ : state) {
+    graph.pub_.publish(image);
+  }
+  graph.setCounters(state);
+}
+BENCHMARK(BM_PublishConstRef)->Apply(benchmarkArguments);
+
+static void BM_PublishConstSharedPtr(benchmark::State & state)
+{
+  BenchmarkGraph graph(state, false);
+  auto image = std::make_shared<const sensor_msgs::msg::Image>(makeImage(graph.size_));
+  auto sub = image_transport::create_subscription(
+    graph.node_, "camera/image", [](const sensor_msgs::msg::Image::ConstSharedPtr &) {}, "raw",
+    rmw_qos_profile_sensor_data);
+  for (auto _ : state) {
+    graph.pub_.publish(image);
+  }
+  graph.setCounters(state);
+}
+BENCHMARK(BM_PublishConstSharedPtr)->Apply(benchmarkArguments);
+
+static void BM_PublishUniquePtr(benchmark::State & state)
+{
+  BenchmarkGraph graph(state, false);
+  const auto image = makeImage(graph.size_);
+  auto sub = image_transport::create_subscription(
+    graph.node_, "camera/image", [](const sensor_msgs::msg::Image::ConstSharedPtr &) {}, "raw",
+    rmw_qos_profile_sensor_data);
+  for (auto _ : state) {
+    // Producing the image is the caller's cost, not the Publisher's.
+    state.PauseTiming();
+    auto message = std::make_unique<sensor_msgs::msg::Image>(image);
+    state.ResumeTiming();
+    graph.pub_.publish(std::move(message));
+  }
+  graph.setCounters(state);
+}
+BENCHMARK(BM_PublishUniquePtr)->Apply(benchmarkArguments);
+
+static void BM_CameraPublish(benchmark::State & state)
+{
+  BenchmarkGraph graph(state, true);
+  auto image = makeImage(graph.size_);
+  sensor_msgs::msg::CameraInfo info;
+  info.width = image.width;
+  info.height = image.height;
+  auto sub = image_transport::create_camera_subscription(
+    graph.node_, "camera/image",
+    [](const sensor_msgs::msg::Image::ConstSharedPtr &,
+    const sensor_msgs::msg::CameraInfo::ConstSharedPtr &) {}, "raw");
+  for (auto _ : state) {
+    graph.camera_pub_.publish(image, info);
+  }
+  graph.setCounters(state);
+}
+BENCHMARK(BM_CameraPublish)->Apply(benchmarkArguments);
+
+static void BM_SubscriptionDelivery(benchmark::State & state)
+{
+  BenchmarkGraph graph(state, false);
+  const auto image = makeImage(graph.size_);
+  std::atomic<int> received{0};
+  auto sub = image_transport::create_subscription(
+    graph.node_, "camera/image",
+    [&received](const sensor_msgs::msg::Image::ConstSharedPtr &) {++received;}, "raw");
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto message = std::make_unique<sensor_msgs::msg::Image>(image);
+    int expected = received + 1;
+    state.ResumeTiming();
+    // Publish to callback latency, through every active plugin.
+    graph.pub_.publish(std::move(message));
+    if (!spinUntil(graph.executor_, [&]() {return received >= expected;})) {
+      state.SkipWithError("Image was not delivered");
+      break;
+    }
+  }
+  graph.setCounters(state);
+}
+BENCHMARK(BM_SubscriptionDelivery)->Apply(benchmarkArguments);
+
+static void BM_CameraSubscriberPairing(benchmark::State & state)
+{
+  BenchmarkGraph graph(state, true);
+  const auto image = makeImage(graph.size_);
+  std::atomic<int> received{0};
+  auto sub = image_transport::create_camera_subscription(
+    graph.node_, "camera/image",
+    [&received](const sensor_msgs::msg::Image::ConstSharedPtr &,
+    const sensor_msgs::msg::CameraInfo::ConstSharedPtr &) {++received;}, "raw");
+  int32_t stamp = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto message = std::make_unique<sensor_msgs::msg::Image>(image);
+    auto info = std::make_unique<sensor_msgs::msg::CameraInfo>();
+    int expected = received + 1;
+    state.ResumeTiming();
+    // Publish to synchronized callback latency, including the TimeSynchronizer.
+    graph.camera_pub_.publish(std::move(message), std::move(info), rclcpp::Time(++stamp, 0));
+    if (!spinUntil(graph.executor_, [&]() {return received >= expected;})) {
+      state.SkipWithError("Camera pair was not delivered");
+      break;
+    }
+  }
+  graph.setCounters(state);
+}
+BENCHMARK(BM_CameraSubscriberPairing)->Apply(benchmarkArguments);
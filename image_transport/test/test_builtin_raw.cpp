@@ -0,0 +1,107 @@
+// Copyright (c) 2024 Open Source Robotics Foundation, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Built with src/builtin_transports.cpp, as libimage_transport is with the
+// IMAGE_TRANSPORT_BUILTIN_RAW CMake option. main() hides every plugin manifest from
+// pluginlib, so the raw transport can only come from the static registry.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+
+#include "image_transport/image_transport.hpp"
+#include "image_transport/static_transport_registry.hpp"
+
+#include "utils.hpp"
+
+TEST(TestBuiltinRaw, registered) {
+  auto & registry = image_transport::StaticTransportRegistry<rclcpp::Node>::instance();
+  EXPECT_TRUE(registry.hasPublisher("image_transport/raw_pub"));
+  EXPECT_TRUE(registry.hasSubscriber("image_transport/raw_sub"));
+  auto & lifecycle_registry =
+    image_transport::StaticTransportRegistry<rclcpp_lifecycle::LifecycleNode>::instance();
+  EXPECT_TRUE(lifecycle_registry.hasPublisher("image_transport/raw_lifecycle_pub"));
+  EXPECT_TRUE(lifecycle_registry.hasSubscriber("image_transport/raw_lifecycle_sub"));
+}
+
+TEST(TestBuiltinRaw, message_passing_without_pluginlib) {
+  using namespace std::chrono_literals;
+
+  rclcpp::NodeOptions options;
+  options.parameter_overrides(
+    {{"camera.image.enable_pub_plugins", std::vector<std::string>{"image_transport/raw"}}});
+  auto node = rclcpp::Node::make_shared("test_builtin_raw", options);
+
+  image_transport::Publisher pub;
+  ASSERT_NO_THROW(pub = image_transport::create_publisher(node, "camera/image"));
+  int received = 0;
+  image_transport::Subscriber sub;
+  ASSERT_NO_THROW(
+    sub = image_transport::create_subscription(
+      node, "camera/image",
+      [&received](const sensor_msgs::msg::Image::ConstSharedPtr &) {++received;}, "raw"));
+  EXPECT_EQ(sub.getTransport(), "raw");
+  test_rclcpp::wait_for_subscriber(node->get_node_graph_interface(), sub.getTopic());
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  for (int loop = 0; loop < 200 && received == 0; ++loop) {
+    pub.publish(sensor_msgs::msg::Image());
+    std::this_thread::sleep_for(10ms);
+    executor.spin_node_some(node);
+  }
+  EXPECT_GT(received, 0);
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  // An empty ament prefix: pluginlib finds no plugins, and no image_transport package.
+  const auto prefix = std::filesystem::temp_directory_path() /
+    ("image_transport_empty_prefix_" + std::to_string(std::random_device()()));
+  std::filesystem::create_directories(prefix);
+#ifdef _WIN32
+  _putenv_s("AMENT_PREFIX_PATH", prefix.string().c_str());
+#else
+  setenv("AMENT_PREFIX_PATH", prefix.string().c_str(), 1);
+#endif
+  testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  std::error_code ec;
+  std::filesystem::remove_all(prefix, ec);
+  rclcpp::shutdown();
+  return ret;
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Open Source Robotics Foundation, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+
+#include "image_transport/testing/allocation_counter.hpp"
+#include "image_transport/testing/conformance.hpp"
+
+IMAGE_TRANSPORT_TESTING_COUNT_ALLOCATIONS()
+
+using image_transport::testing::ConformanceOptions;
+using image_transport::testing::ConformanceResult;
+
+namespace
+{
+
+// Every frame must be delivered, and lossless transports must deliver bit-exact images. The
+// measurements are recorded as test properties so CI can track them from the XML output.
+void expectConformance(
+  const ConformanceOptions & options, const std::vector<ConformanceResult> & results,
+  bool lossless)
+{
+  ASSERT_FALSE(results.empty()) <<
+    "No subscriber matched for transport '" << options.transport << "'";
+  image_transport::testing::printConformanceReport(std::cout, options.transport, results);
+  for (const auto & result : results) {
+    EXPECT_EQ(result.frames_received, result.frames_sent) << result.image;
+    EXPECT_EQ(result.frames_sent, options.frames) << result.image;
+    EXPECT_GT(result.encode_mbps, 0.0) << result.image;
+    if (lossless) {
+      EXPECT_TRUE(result.bit_exact) << result.image << ": max abs error " <<
+        result.max_abs_error;
+    }
+    const std::string prefix = result.image + ".";
+    ::testing::Test::RecordProperty(prefix + "encode_mbps", std::to_string(result.encode_mbps));
+    ::testing::Test::RecordProperty(prefix + "decode_mbps", std::to_string(result.decode_mbps));
+    ::testing::Test::RecordProperty(
+      prefix + "mean_latency_us", std::to_string(result.mean_latency_us));
+    ::testing::Test::RecordProperty(
+      prefix + "compression_ratio", std::to_string(result.compression_ratio));
+    ::testing::Test::RecordProperty(
+      prefix + "allocations_per_frame", std::to_string(result.allocations_per_frame));
+  }
+}
+
+}  // namespace
+
+TEST(ImageTransportConformance, raw) {
+  ConformanceOptions options;
+  options.transport = "raw";
+  expectConformance(options, image_transport::testing::runConformance(options), true);
+}
+
+TEST(ImageTransportConformance, corpus_is_deterministic) {
+  auto first = image_transport::testing::standardCorpus(64, 48);
+  auto second = image_transport::testing::standardCorpus(64, 48);
+  ASSERT_EQ(first.size(), second.size());
+  for (size_t i = 0; i < first.size(); ++i) {
+    EXPECT_EQ(first[i].image, second[i].image) << first[i].name;
+    EXPECT_EQ(first[i].image.data.size(), first[i].image.step * first[i].image.height);
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return ret;
+}
@@ -0,0 +1,174 @@
+// Copyright (c) 2024 Open Source Robotics Foundation, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the copyright holder nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+
+#include "image_transport/image_transport.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+void setAmentPrefixPath(const std::string & value)
+{
+#ifdef _WIN32
+  _putenv_s("AMENT_PREFIX_PATH", value.c_str());
+#else
+  setenv("AMENT_PREFIX_PATH", value.c_str(), 1);
+#endif
+}
+
+#ifdef _WIN32
+const char kPathSeparator = ';';
+#else
+const char kPathSeparator = ':';
+#endif
+
+bool contains(const std::vector<std::string> & transports, const std::string & transport)
+{
+  return std::find(transports.begin(), transports.end(), transport) != transports.end();
+}
+
+/**
+ * An ament prefix that declares one more subscriber plugin, "image_transport/extra_raw".
+ * It is the raw subscriber from this package's own plugin library, so it always loads.
+ */
+class ExtraPluginPrefix
+{
+public:
+  ExtraPluginPrefix()
+  : prefix_(fs::temp_directory_path() /
+      ("image_transport_test_prefix_" + std::to_string(std::random_device()())))
+  {
+    const fs::path share = prefix_ / "share" / "image_transport_extra";
+    fs::create_directories(share);
+    // pluginlib resolves the library through the package named here.
+    std::ofstream(share / "package.xml") <<
+      "<package format=\"3\"><name>image_transport</name></package>\n";
+    std::ofstream(share / "extra_plugins.xml") <<
+      "<library path=\"image_transport_plugins\">\n"
+      "  <class name=\"image_transport/extra_raw_sub\"\n"
+      "    type=\"image_transport::RawSubscriber&lt;rclcpp::Node&gt;\"\n"
+      "    base_class_type=\"image_transport::SubscriberPlugin&lt;rclcpp::Node&gt;\">\n"
+      "    <description>A second raw subscriber.</description>\n"
+      "  </class>\n"
+      "</library>\n";
+    const fs::path index =
+      prefix_ / "share" / "ament_index" / "resource_index" /
+      "image_transport__pluginlib__plugin";
+    fs::create_directories(index);
+    std::ofstream(index / "image_transport_extra") <<
+      "share/image_transport_extra/extra_plugins.xml\n";
+  }
+
+  ~ExtraPluginPrefix()
+  {
+    std::error_code ec;
+    fs::remove_all(prefix_, ec);
+  }
+
+  std::string path() const
+  {
+    return prefix_.string();
+  }
+
+private:
+  fs::path prefix_;
+};
+
+}  // namespace
+
+TEST(TestLoadableTransports, cached) {
+  auto transports = image_transport::getLoadableTransports();
+  EXPECT_TRUE(contains(transports, "image_transport/raw"));
+  EXPECT_EQ(image_transport::getLoadableTransports(), transports);
+
+  // Concurrent callers share the cache while others use the plugin loaders.
+  auto node = rclcpp::Node::make_shared("test_loadable_transports");
+  std::function<void(const sensor_msgs::msg::Image::ConstSharedPtr &)> fcn =
+    [](const auto & msg) {(void)msg;};
+  std::vector<std::thread> threads;
+  std::vector<std::vector<std::string>> results(4);
+  for (size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back(
+      [&, i]() {
+        for (int j = 0; j < 10; ++j) {
+          results[i] = image_transport::getLoadableTransports();
+          auto sub = image_transport::create_subscription(
+            node, "camera_" + std::to_string(i) + "/image", fcn, "raw");
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  for (const auto & result : results) {
+    EXPECT_EQ(result, transports);
+  }
+}
+
+TEST(TestLoadableTransports, invalidated_by_manifest_changes) {
+  const char * original = std::getenv("AMENT_PREFIX_PATH");
+  ASSERT_NE(original, nullptr);
+  const std::string original_path = original;
+  auto transports = image_transport::getLoadableTransports();
+  EXPECT_FALSE(contains(transports, "image_transport/extra_raw"));
+
+  {
+    // A new package registering plugins is picked up...
+    ExtraPluginPrefix extra;
+    setAmentPrefixPath(extra.path() + kPathSeparator + original_path);
+    EXPECT_TRUE(contains(image_transport::getLoadableTransports(), "image_transport/extra_raw"));
+  }
+
+  // ...and so is its removal.
+  setAmentPrefixPath(original_path);
+  EXPECT_EQ(image_transport::getLoadableTransports(), transports);
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return ret;
+}
@@ -150,6 +150,125 @@ TEST_F(MessagePassingTesting, one_camera_message_passing)
   ASSERT_EQ(1, total_images_received);
 }
 
+TEST_F(MessagePassingTesting, camera_message_passing_shared_info)
+{
+  const size_t max_retries = 3;
+  const size_t max_loops = 200;
+  const std::chrono::milliseconds sleep_per_loop = std::chrono::milliseconds(10);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+
+  auto pub = image_transport::create_camera_publisher(node_, "camera/image");
+  int32_t info_stamp = -1;
+  auto sub = image_transport::create_camera_subscription(
+    node_, "camera/image",
+    [&info_stamp](const sensor_msgs::msg::Image::ConstSharedPtr & image,
+    const sensor_msgs::msg::CameraInfo::ConstSharedPtr & info) {
+      (void) image;
+      info_stamp = info->header.stamp.sec;
+      total_images_received++;
+    },
+    "raw"
+  );
+
+  test_rclcpp::wait_for_subscriber(node_->get_node_graph_interface(), sub.getTopic());
+
+  // An immutable info shared between frames, as from getCameraInfoSnapshot().
+  auto info = std::make_shared<const sensor_msgs::msg::CameraInfo>();
+
+  size_t retry = 0;
+  while (retry < max_retries && total_images_received == 0) {
+    auto image = generate_random_image();
+    image->header.stamp.sec = 42;
+    pub.publish(std::move(image), info);
+
+    executor.spin_node_some(node_);
+    size_t loop = 0;
+    while ((total_images_received != 1) && (loop++ < max_loops)) {
+      std::this_thread::sleep_for(sleep_per_loop);
+      executor.spin_node_some(node_);
+    }
+  }
+
+  ASSERT_EQ(1, total_images_received);
+  EXPECT_EQ(42, info_stamp);
+  EXPECT_EQ(0, info->header.stamp.sec);
+}
+
+TEST_F(MessagePassingTesting, subscriber_statistics)
+{
+  const size_t max_loops = 200;
+  const std::chrono::milliseconds sleep_per_loop = std::chrono::milliseconds(10);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+
+  auto pub = image_transport::create_publisher(node_, "camera/image");
+  auto sub =
+    image_transport::create_subscription(node_, "camera/image", imageCallback, "raw");
+
+  image_transport::SubscriberStatisticsOptions options;
+  options.expected_rate = 10.0;
+  sub.enableStatistics(options);
+
+  test_rclcpp::wait_for_subscriber(node_->get_node_graph_interface(), sub.getTopic());
+
+  // Stamps 0.0, 0.1 and 0.4 s at 10 Hz: the last gap hides two missing images.
+  for (int32_t nanosec : {0, 100000000, 400000000}) {
+    auto image = generate_random_image();
+    image->header.stamp.sec = 1;
+    image->header.stamp.nanosec = nanosec;
+    pub.publish(std::move(image));
+  }
+
+  size_t loop = 0;
+  while ((total_images_received != 3) && (loop++ < max_loops)) {
+    std::this_thread::sleep_for(sleep_per_loop);
+    executor.spin_node_some(node_);
+  }
+  ASSERT_EQ(3, total_images_received);
+
+  auto statistics = sub.getStatistics();
+  EXPECT_EQ(3u, statistics.received);
+  EXPECT_EQ(2u, statistics.estimated_drops);
+  EXPECT_EQ(3u, statistics.callback_duration.count);
+  EXPECT_EQ(3u, statistics.age.count);
+  EXPECT_EQ(2u, statistics.inter_arrival.count);
+  uint64_t histogram_total = 0;
+  for (auto bucket : statistics.age_histogram) {
+    histogram_total += bucket;
+  }
+  EXPECT_EQ(3u, histogram_total);
+
+  sub.resetStatistics();
+  EXPECT_EQ(0u, sub.getStatistics().received);
+}
+
+TEST_F(MessagePassingTesting, subscriber_statistics_teardown)
+{
+  // Destroy subscribers while another thread is busy delivering their images and
+  // publishing their statistics; pending callbacks must not touch the freed subscriber.
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node_);
+  std::thread spinner([&executor]() {executor.spin();});
+
+  auto pub = image_transport::create_publisher(node_, "camera/image");
+  for (int i = 0; i < 20; ++i) {
+    auto sub =
+      image_transport::create_subscription(node_, "camera/image", imageCallback, "raw");
+    image_transport::SubscriberStatisticsOptions options;
+    options.topic = "camera/image/statistics";
+    options.publish_period = std::chrono::milliseconds(1);
+    sub.enableStatistics(options);
+    for (int j = 0; j < 10; ++j) {
+      pub.publish(generate_random_image());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  executor.cancel();
+  spinner.join();
+}
+
 /*
 TEST_F(MessagePassingTesting, stress_message_passing)
 {
@@ -28,12 +28,46 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <string>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 
 #include "image_transport/image_transport.hpp"
+#include "image_transport/raw_publisher.hpp"
+#include "image_transport/static_transport_registry.hpp"
+
+static std::atomic<int> sleepy_instances{0};
+
+// A lazy-capable transport whose topic does not follow the "<base>/<transport>" naming.
+template<class NodeType>
+class SleepyPublisher : public image_transport::RawPublisher<NodeType>
+{
+public:
+  SleepyPublisher()
+  {
+    ++sleepy_instances;
+  }
+
+  std::string getTransportName() const override
+  {
+    return "sleepy";
+  }
+
+protected:
+  std::string getTopicToAdvertise(const std::string & base_topic) const override
+  {
+    return base_topic + "/sleepy_topic";
+  }
+};
+
+IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(
+  rclcpp::Node, SleepyPublisher<rclcpp::Node>, "image_transport/sleepy_pub")
 
 class TestPublisher : public ::testing::Test
 {
@@ -56,6 +90,62 @@ TEST_F(TestPublisher, publisher) {
   pub.publish(sensor_msgs::msg::Image::ConstSharedPtr());
 }
 
+TEST_F(TestPublisher, lazy_raw_publisher) {
+  // The raw transport owns the base topic and is advertised even when listed as lazy.
+  node_->declare_parameter<std::vector<std::string>>(
+    "camera.image.lazy_pub_plugins", {"image_transport/raw"});
+  auto pub = image_transport::create_publisher(node_, "camera/image");
+  EXPECT_EQ(node_->get_node_graph_interface()->count_publishers("camera/image"), 1u);
+  EXPECT_TRUE(node_->has_parameter("camera.image.lazy_pub_plugins_grace_period"));
+  pub.shutdown();
+  EXPECT_EQ(node_->get_node_graph_interface()->count_publishers("camera/image"), 0u);
+}
+
+TEST_F(TestPublisher, lazy_publisher_wakes_and_sleeps) {
+  using namespace std::chrono_literals;
+
+  node_->declare_parameter<std::vector<std::string>>(
+    "camera.image.enable_pub_plugins", {"image_transport/raw", "image_transport/sleepy"});
+  node_->declare_parameter<std::vector<std::string>>(
+    "camera.image.lazy_pub_plugins", {"image_transport/sleepy"});
+  node_->declare_parameter<double>("camera.image.lazy_pub_plugins_grace_period", 0.2);
+  node_->declare_parameter<std::string>("camera.image.sleepy.lazy_topic", "sleepy_topic");
+  sleepy_instances = 0;
+  auto pub = image_transport::create_publisher(node_, "camera/image");
+  auto graph = node_->get_node_graph_interface();
+  EXPECT_EQ(graph->count_publishers("camera/image"), 1u);
+  EXPECT_EQ(graph->count_publishers("camera/image/sleepy_topic"), 0u);
+  // A dormant plugin is not even constructed.
+  EXPECT_EQ(sleepy_instances, 0);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node_);
+  auto spin_until = [&](const std::function<bool()> & done) {
+      const auto deadline = std::chrono::steady_clock::now() + 5s;
+      while (!done() && std::chrono::steady_clock::now() < deadline) {
+        executor.spin_some(100ms);
+        std::this_thread::sleep_for(50ms);
+      }
+      return done();
+    };
+
+  // A subscriber on the plugin's own topic wakes it up...
+  auto sub = node_->create_subscription<sensor_msgs::msg::Image>(
+    "camera/image/sleepy_topic", 1, [](sensor_msgs::msg::Image::ConstSharedPtr) {});
+  auto sleepy_publishers = [&]() {return graph->count_publishers("camera/image/sleepy_topic");};
+  EXPECT_TRUE(spin_until([&]() {return sleepy_publishers() == 1;}));
+  EXPECT_EQ(pub.getNumSubscribers(), 1u);
+  EXPECT_EQ(sleepy_instances, 1);
+
+  // ...and once it has been gone for the grace period the plugin is torn down again.
+  sub.reset();
+  EXPECT_TRUE(spin_until([&]() {return sleepy_publishers() == 0;}));
+  EXPECT_EQ(graph->count_publishers("camera/image"), 1u);
+
+  pub.shutdown();
+  EXPECT_EQ(graph->count_publishers("camera/image"), 0u);
+}
+
 TEST_F(TestPublisher, image_transport_publisher) {
   image_transport::ImageTransport it(node_);
   auto pub = it.advertise("camera/image", 1);
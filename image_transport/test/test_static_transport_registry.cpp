@@ -0,0 +1,100 @@
+// Copyright (c) 2024 Open Source Robotics Foundation, Inc.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Willow Garage nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+
+#include "image_transport/image_transport.hpp"
+#include "image_transport/raw_publisher.hpp"
+#include "image_transport/raw_subscriber.hpp"
+#include "image_transport/static_transport_registry.hpp"
+
+// A second copy of raw, known only to the static registry.
+IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(
+  rclcpp::Node, image_transport::RawPublisher<rclcpp::Node>, "image_transport/static_raw_pub")
+IMAGE_TRANSPORT_REGISTER_STATIC_SUBSCRIBER(
+  rclcpp::Node, image_transport::RawSubscriber<rclcpp::Node>, "image_transport/static_raw_sub")
+
+class TestStaticTransportRegistry : public ::testing::Test
+{
+protected:
+  void SetUp()
+  {
+    node_ = rclcpp::Node::make_shared("test_static_transport_registry");
+  }
+
+  rclcpp::Node::SharedPtr node_;
+};
+
+TEST_F(TestStaticTransportRegistry, registration) {
+  auto & registry = image_transport::StaticTransportRegistry<rclcpp::Node>::instance();
+  EXPECT_TRUE(registry.hasPublisher("image_transport/static_raw_pub"));
+  EXPECT_TRUE(registry.hasSubscriber("image_transport/static_raw_sub"));
+  EXPECT_FALSE(registry.hasSubscriber("image_transport/static_raw_pub"));
+  EXPECT_EQ(registry.createPublisher("image_transport/unknown_pub"), nullptr);
+  EXPECT_NE(registry.createSubscriber("image_transport/static_raw_sub"), nullptr);
+
+  auto & lifecycle_registry =
+    image_transport::StaticTransportRegistry<rclcpp_lifecycle::LifecycleNode>::instance();
+  EXPECT_FALSE(lifecycle_registry.hasPublisher("image_transport/static_raw_pub"));
+}
+
+TEST_F(TestStaticTransportRegistry, declared_transports) {
+  auto transports = image_transport::getDeclaredTransports();
+  EXPECT_NE(
+    std::find(transports.begin(), transports.end(), "image_transport/static_raw"),
+    transports.end());
+}
+
+TEST_F(TestStaticTransportRegistry, publish_and_subscribe) {
+  // Both raw and static_raw are enabled by default and advertise the base topic.
+  auto pub = image_transport::create_publisher(node_, "camera/image");
+  EXPECT_EQ(node_->get_node_graph_interface()->count_publishers("camera/image"), 2u);
+
+  std::function<void(const sensor_msgs::msg::Image::ConstSharedPtr & msg)> fcn =
+    [](const auto & msg) {(void)msg;};
+  auto sub = image_transport::create_subscription(node_, "camera/image", fcn, "static_raw");
+  EXPECT_EQ(sub.getTransport(), "raw");
+  EXPECT_EQ(node_->get_node_graph_interface()->count_subscribers("camera/image"), 1u);
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return ret;
+}
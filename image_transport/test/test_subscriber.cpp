@@ -34,10 +34,52 @@
 #include <chrono>
 #include <atomic>
 #include <thread>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 
 #include "image_transport/image_transport.hpp"
+#include "image_transport/raw_publisher.hpp"
+#include "image_transport/raw_subscriber.hpp"
+#include "image_transport/static_transport_registry.hpp"
+
+// Stands in for compressed_image_transport: raw images on "<base>/compressed".
+template<class NodeType>
+class FakeCompressedPublisher : public image_transport::RawPublisher<NodeType>
+{
+public:
+  std::string getTransportName() const override
+  {
+    return "compressed";
+  }
+
+protected:
+  std::string getTopicToAdvertise(const std::string & base_topic) const override
+  {
+    return base_topic + "/compressed";
+  }
+};
+
+template<class NodeType>
+class FakeCompressedSubscriber : public image_transport::RawSubscriber<NodeType>
+{
+public:
+  std::string getTransportName() const override
+  {
+    return "compressed";
+  }
+
+protected:
+  std::string getTopicToSubscribe(const std::string & base_topic) const override
+  {
+    return base_topic + "/compressed";
+  }
+};
+
+IMAGE_TRANSPORT_REGISTER_STATIC_PUBLISHER(
+  rclcpp::Node, FakeCompressedPublisher<rclcpp::Node>, "image_transport/compressed_pub")
+IMAGE_TRANSPORT_REGISTER_STATIC_SUBSCRIBER(
+  rclcpp::Node, FakeCompressedSubscriber<rclcpp::Node>, "image_transport/compressed_sub")
 
 class TestSubscriber : public ::testing::Test
 {
@@ -84,6 +126,136 @@ TEST_F(TestSubscriber, camera_sub_shutdown) {
   EXPECT_EQ(node_->get_node_graph_interface()->count_subscribers("camera/camera_info"), 0u);
 }
 
+TEST_F(TestSubscriber, auto_transport_local_publisher) {
+  std::function<void(const sensor_msgs::msg::Image::ConstSharedPtr & msg)> fcn =
+    [](const auto & msg) {(void)msg;};
+
+  auto node_publisher = rclcpp::Node::make_shared("image_publisher", rclcpp::NodeOptions());
+  auto pub = image_transport::create_publisher(node_publisher, "camera/image");
+
+  // A publisher in this process is always consumed as raw.
+  auto sub = image_transport::create_subscription(node_, "camera/image", fcn, "auto");
+  EXPECT_EQ(sub.getTransport(), "raw");
+  EXPECT_EQ(sub.getTopic(), "/camera/image");
+  EXPECT_TRUE(node_->has_parameter("camera.image.auto_remote_transport"));
+  EXPECT_EQ(node_->get_node_graph_interface()->count_subscribers("/camera/image"), 1u);
+  sub.shutdown();
+  EXPECT_EQ(node_->get_node_graph_interface()->count_subscribers("/camera/image"), 0u);
+}
+
+TEST_F(TestSubscriber, auto_transport_local_publisher_without_raw) {
+  std::function<void(const sensor_msgs::msg::Image::ConstSharedPtr & msg)> fcn =
+    [](const auto & msg) {(void)msg;};
+
+  rclcpp::NodeOptions options;
+  options.parameter_overrides(
+    {{"camera.image.enable_pub_plugins", std::vector<std::string>{"image_transport/compressed"}}});
+  auto node_publisher = rclcpp::Node::make_shared("image_publisher", options);
+  auto pub = image_transport::create_publisher(node_publisher, "camera/image");
+
+  // The local publisher does not offer raw, so the remote transport is used instead.
+  auto sub = image_transport::create_subscription(node_, "camera/image", fcn, "auto");
+  EXPECT_EQ(sub.getTransport(), "compressed");
+  EXPECT_EQ(node_->get_node_graph_interface()->count_subscribers("/camera/image"), 0u);
+  EXPECT_EQ(
+    node_->get_node_graph_interface()->count_subscribers("/camera/image/compressed"), 1u);
+}
+
+TEST_F(TestSubscriber, auto_transport_remote_publisher) {
+  using namespace std::chrono_literals;
+
+  std::function<void(const sensor_msgs::msg::Image::ConstSharedPtr & msg)> fcn =
+    [](const auto & msg) {(void)msg;};
+
+  // Nothing publishes yet, so the subscriber starts on raw.
+  auto sub = image_transport::create_subscription(node_, "camera/image", fcn, "auto");
+  EXPECT_EQ(sub.getTransport(), "raw");
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node_);
+  auto spin_until_transport = [&](const std::string & transport) {
+      const auto deadline = std::chrono::steady_clock::now() + 5s;
+      while (sub.getTransport() != transport && std::chrono::steady_clock::now() < deadline) {
+        executor.spin_some(100ms);
+        std::this_thread::sleep_for(50ms);
+      }
+      return sub.getTransport();
+    };
+
+  // A plain publisher on the compressed topic looks like a publisher in another process.
+  auto node_publisher = rclcpp::Node::make_shared("image_publisher", rclcpp::NodeOptions());
+  auto remote_pub = node_publisher->create_publisher<sensor_msgs::msg::Image>(
+    "camera/image/compressed", 1);
+  EXPECT_EQ(spin_until_transport("compressed"), "compressed");
+  EXPECT_EQ(
+    node_->get_node_graph_interface()->count_subscribers("/camera/image/compressed"), 1u);
+  EXPECT_EQ(node_->get_node_graph_interface()->count_subscribers("/camera/image"), 0u);
+
+  // Once it goes away the subscriber falls back to raw.
+  remote_pub.reset();
+  EXPECT_EQ(spin_until_transport("raw"), "raw");
+  EXPECT_EQ(node_->get_node_graph_interface()->count_subscribers("/camera/image"), 1u);
+
+  sub.shutdown();
+  executor.spin_some(100ms);
+}
+
+TEST_F(TestSubscriber, dedicated_executor_thread) {
+  using namespace std::chrono_literals;
+
+  auto node_publisher = rclcpp::Node::make_shared("image_publisher", rclcpp::NodeOptions());
+  auto pub = image_transport::create_publisher(node_publisher, "camera/image");
+
+  std::atomic<bool> received = false;
+  std::atomic<bool> on_main_thread = false;
+  const auto main_thread = std::this_thread::get_id();
+  std::function<void(const sensor_msgs::msg::Image::ConstSharedPtr & msg)> fcn =
+    [&](const auto & msg) {
+      (void)msg;
+      on_main_thread = std::this_thread::get_id() == main_thread;
+      received = true;
+    };
+
+  image_transport::CallbackIsolation isolation;
+  isolation.dedicated_executor_thread = true;
+  auto sub = image_transport::create_subscription(
+    node_, "camera/image", fcn, "raw", rmw_qos_profile_default,
+    rclcpp::SubscriptionOptions(), isolation);
+
+  // Nothing spins node_ here, the subscription's own executor thread must deliver the image.
+  auto msg = sensor_msgs::msg::Image();
+  for (int i = 0; i < 50 && !received; ++i) {
+    pub.publish(msg);
+    std::this_thread::sleep_for(100ms);
+  }
+  sub.shutdown();
+
+  EXPECT_TRUE(received);
+  EXPECT_FALSE(on_main_thread);
+}
+
+TEST_F(TestSubscriber, dedicated_executor_thread_immediate_shutdown) {
+  std::function<void(const sensor_msgs::msg::Image::ConstSharedPtr & msg)> fcn =
+    [](const auto & msg) {(void)msg;};
+
+  image_transport::CallbackIsolation isolation;
+  isolation.dedicated_executor_thread = true;
+  // Shutting down before the executor thread starts spinning must not hang.
+  for (int i = 0; i < 20; ++i) {
+    auto sub = image_transport::create_subscription(
+      node_, "camera/image", fcn, "raw", rmw_qos_profile_default,
+      rclcpp::SubscriptionOptions(), isolation);
+    sub.shutdown();
+  }
+  for (int i = 0; i < 20; ++i) {
+    auto sub = image_transport::create_camera_subscription(
+      node_, "camera/image",
+      [](const auto & image, const auto & info) {(void)image; (void)info;}, "raw",
+      rmw_qos_profile_default, rclcpp::SubscriptionOptions(), isolation);
+    sub.shutdown();
+  }
+}
+
 TEST_F(TestSubscriber, callback_groups) {
   using namespace std::chrono_literals;
 